@@ -69,14 +69,8 @@ ofxHttpImage::image_from_buffer(std::shared_ptr<ofBuffer> buffy){
 rxcpp::observable<std::shared_ptr<ofPixels>>
 ofxHttpImage::http_image(const ofxRx::HttpProgress& hp) {
     return hp.
-        body().
-        scan(
-             std::make_shared<ofBuffer>(),
-             [](std::shared_ptr<ofBuffer> acc, ofxRx::BufferRef<char> b){
-                 acc->append(b.begin(), b.size());
-                 return acc;
-             }).
-        last().
+        // one allocation from the Content-Length
+        collect().
         // got all the data, do heavy lifting on the background thread
         map(image_from_buffer);
 }
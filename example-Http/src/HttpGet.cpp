@@ -16,7 +16,7 @@ HttpGet::HttpGet(std::string u, int h):
 rx::observable<HttpGet*> HttpGet::image_from_body(ofxRx::HttpProgress& hp){
     return hp.body().
         reduce(this,
-            [](HttpGet* hg, ofxRx::BufferRef<char> br){
+            [](HttpGet* hg, ofxRx::HttpChunk br){
                 if (!hg->response) {
                     hg->response = std::addressof(br.getResponse());
                 }
@@ -0,0 +1,343 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved. See License.txt in the project root for license information.
+
+#pragma once
+
+#if !defined(RXCPP_OPERATORS_RX_BUFFER_TIME_HPP)
+#define RXCPP_OPERATORS_RX_BUFFER_TIME_HPP
+
+#include "../rx-includes.hpp"
+
+namespace rxcpp {
+
+namespace operators {
+
+namespace detail {
+
+// buffers are opened and closed by timers on the coordination's worker and,
+// when count is not zero, closed early when they hold count values.
+// all the open buffers share one store of values. each value is stored
+// once and is copied only into the buffers that are emitted while another
+// buffer still needs it.
+template<class T, class Coordination>
+struct buffer_with_time
+{
+    typedef typename std::decay<T>::type source_value_type;
+    typedef std::vector<source_value_type> value_type;
+    typedef typename std::decay<Coordination>::type coordination_type;
+    typedef typename coordination_type::coordinator_type coordinator_type;
+    typedef rxsc::scheduler::clock_type clock_type;
+
+    struct buffer_with_time_values
+    {
+        buffer_with_time_values(clock_type::duration p, clock_type::duration s, size_t c, coordination_type cn)
+            : period(p)
+            , skip(s)
+            , count(c)
+            , coordination(std::move(cn))
+        {
+        }
+        clock_type::duration period;
+        clock_type::duration skip;
+        // zero when buffers are only closed by time
+        size_t count;
+        coordination_type coordination;
+    };
+
+    buffer_with_time_values initial;
+
+    buffer_with_time(clock_type::duration period, clock_type::duration skip, size_t count, coordination_type cn)
+        : initial(period, skip, count, std::move(cn))
+    {
+        // the timers would open buffers forever without time passing
+        if (period <= clock_type::duration::zero() || skip <= clock_type::duration::zero()) {
+            throw std::invalid_argument("buffer_with_time period and skip must be greater than zero");
+        }
+    }
+
+    template<class Subscriber>
+    struct buffer_with_time_observer
+    {
+        typedef buffer_with_time_observer<Subscriber> this_type;
+        typedef typename std::decay<Subscriber>::type dest_type;
+        typedef observer<source_value_type, this_type> observer_type;
+
+        struct open_buffer
+        {
+            // the sequence number of the first value
+            size_t start;
+            clock_type::time_point deadline;
+        };
+
+        struct buffer_with_time_state
+            : public timed_state<buffer_with_time_values, coordination_type, dest_type>
+            , public std::enable_shared_from_this<buffer_with_time_state>
+        {
+            buffer_with_time_state(dest_type d, buffer_with_time_values v, coordinator_type coor, composite_subscription cs)
+                : timed_state<buffer_with_time_values, coordination_type, dest_type>(std::move(d), std::move(v), std::move(coor), std::move(cs))
+                , base(0)
+                , completed(false)
+            {
+            }
+
+            std::mutex lock;
+            // the values in the open and ready buffers.
+            // store[i] has the sequence number base + i
+            std::deque<source_value_type> store;
+            size_t base;
+            std::deque<open_buffer> open;
+            // the [first, last) sequence numbers of the closed buffers
+            std::deque<std::pair<size_t, size_t>> ready;
+            clock_type::time_point next_open;
+            bool completed;
+
+            // must be called with lock held
+            size_t next() const {
+                return base + store.size();
+            }
+
+            // must be called with lock held
+            void close_front() {
+                ready.push_back(std::make_pair(open.front().start, next()));
+                open.pop_front();
+            }
+
+            // must be called with lock held. opens and closes the buffers
+            // that are due by now and returns when the next one is due.
+            clock_type::time_point advance(clock_type::time_point now) {
+                for (;;) {
+                    bool closing = !open.empty() && open.front().deadline <= now;
+                    bool opening = this->values.count == 0 && next_open <= now;
+                    if (closing && (!opening || open.front().deadline <= next_open)) {
+                        auto deadline = open.front().deadline;
+                        close_front();
+                        if (this->values.count != 0) {
+                            open_buffer b = {next(), deadline + this->values.period};
+                            open.push_back(b);
+                        }
+                    } else if (opening) {
+                        open_buffer b = {next(), next_open + this->values.period};
+                        open.push_back(b);
+                        next_open += this->values.skip;
+                    } else {
+                        break;
+                    }
+                }
+                auto wake = open.empty() ? clock_type::time_point::max() : open.front().deadline;
+                if (this->values.count == 0) {
+                    wake = std::min(wake, next_open);
+                }
+                return wake;
+            }
+
+            // must only be called on the worker
+            void flush() {
+                std::vector<value_type> buffers;
+                {
+                    std::unique_lock<std::mutex> guard(lock);
+                    while (!ready.empty()) {
+                        auto range = ready.front();
+                        ready.pop_front();
+
+                        // values before the start of every other buffer
+                        // are not needed again and are moved
+                        auto shared = range.second;
+                        if (!ready.empty()) {
+                            shared = std::min(shared, ready.front().first);
+                        }
+                        if (!open.empty()) {
+                            shared = std::min(shared, open.front().start);
+                        }
+
+                        value_type buffer;
+                        buffer.reserve(range.second - range.first);
+                        for (auto i = range.first; i != range.second; ++i) {
+                            auto& v = store[i - base];
+                            if (i < shared) {
+                                buffer.push_back(std::move(v));
+                            } else {
+                                buffer.push_back(v);
+                            }
+                        }
+                        buffers.push_back(std::move(buffer));
+                    }
+
+                    auto keep = open.empty() ? next() : open.front().start;
+                    while (base < keep) {
+                        store.pop_front();
+                        ++base;
+                    }
+                }
+                for (auto& b : buffers) {
+                    this->dest.on_next(std::move(b));
+                }
+            }
+
+            void tick(const rxsc::schedulable& self) {
+                clock_type::time_point wake;
+                {
+                    std::unique_lock<std::mutex> guard(lock);
+                    if (completed) {
+                        return;
+                    }
+                    wake = advance(this->worker.now());
+                }
+                flush();
+                if (wake != clock_type::time_point::max()) {
+                    self.schedule(wake);
+                }
+            }
+
+            void schedule_flush() {
+                auto keepAlive = this->shared_from_this();
+                this->schedule([keepAlive](const rxsc::schedulable&){
+                    keepAlive->flush();
+                });
+            }
+        };
+        std::shared_ptr<buffer_with_time_state> state;
+
+        explicit buffer_with_time_observer(std::shared_ptr<buffer_with_time_state> s)
+            : state(std::move(s))
+        {
+        }
+
+        void on_next(source_value_type v) const {
+            bool cut = false;
+            {
+                std::unique_lock<std::mutex> guard(state->lock);
+                if (state->completed || state->open.empty()) {
+                    // not in any buffer
+                    return;
+                }
+                state->store.push_back(std::move(v));
+                if (state->values.count != 0 && state->next() - state->open.front().start >= state->values.count) {
+                    state->close_front();
+                    open_buffer b = {state->next(), state->worker.now() + state->values.period};
+                    state->open.push_back(b);
+                    cut = true;
+                }
+            }
+            if (cut) {
+                state->schedule_flush();
+            }
+        }
+        void on_error(std::exception_ptr e) const {
+            {
+                std::unique_lock<std::mutex> guard(state->lock);
+                if (state->completed) {
+                    return;
+                }
+                state->completed = true;
+            }
+            auto keepAlive = state;
+            state->schedule([keepAlive, e](const rxsc::schedulable&){
+                keepAlive->dest.on_error(e);
+                keepAlive->lifetime.unsubscribe();
+            });
+        }
+        void on_completed() const {
+            {
+                std::unique_lock<std::mutex> guard(state->lock);
+                if (state->completed) {
+                    return;
+                }
+                state->completed = true;
+            }
+            auto keepAlive = state;
+            state->schedule([keepAlive](const rxsc::schedulable&){
+                {
+                    std::unique_lock<std::mutex> guard(keepAlive->lock);
+                    while (!keepAlive->open.empty()) {
+                        keepAlive->close_front();
+                    }
+                }
+                keepAlive->flush();
+                keepAlive->dest.on_completed();
+                keepAlive->lifetime.unsubscribe();
+            });
+        }
+
+        static subscriber<source_value_type, observer_type> make(dest_type d, buffer_with_time_values v) {
+            auto state = make_timed_state<buffer_with_time_state>(d, std::move(v));
+
+            clock_type::time_point wake;
+            {
+                std::unique_lock<std::mutex> guard(state->lock);
+                auto now = state->worker.now();
+                open_buffer b = {0, now + state->values.period};
+                state->open.push_back(b);
+                state->next_open = now + state->values.skip;
+                wake = state->advance(now);
+            }
+
+            auto tick = timed_action(state, [](buffer_with_time_state& s, const rxsc::schedulable& self){
+                s.tick(self);
+            });
+            if (!tick.empty()) {
+                tick->schedule(wake);
+            }
+
+            return make_subscriber<source_value_type>(d, state->lifetime, observer_type(this_type(state)));
+        }
+    };
+
+    template<class Subscriber>
+    auto operator()(Subscriber dest) const
+        -> decltype(buffer_with_time_observer<Subscriber>::make(std::move(dest), initial)) {
+        return      buffer_with_time_observer<Subscriber>::make(std::move(dest), initial);
+    }
+};
+
+template<class Coordination>
+class buffer_with_time_factory
+{
+    typedef typename std::decay<Coordination>::type coordination_type;
+    typedef rxsc::scheduler::clock_type clock_type;
+
+    clock_type::duration period;
+    clock_type::duration skip;
+    size_t count;
+    coordination_type coordination;
+public:
+    buffer_with_time_factory(clock_type::duration p, clock_type::duration s, size_t c, coordination_type cn)
+        : period(p)
+        , skip(s)
+        , count(c)
+        , coordination(std::move(cn))
+    {
+    }
+    template<class Observable>
+    auto operator()(Observable&& source)
+        -> decltype(source.template lift<std::vector<typename std::decay<Observable>::type::value_type>>(buffer_with_time<typename std::decay<Observable>::type::value_type, Coordination>(period, skip, count, coordination))) {
+        return      source.template lift<std::vector<typename std::decay<Observable>::type::value_type>>(buffer_with_time<typename std::decay<Observable>::type::value_type, Coordination>(period, skip, count, coordination));
+    }
+};
+
+}
+
+/// emits the values received in each period, timed on the worker of cn
+template<class Coordination>
+inline auto buffer_with_time(rxsc::scheduler::clock_type::duration period, Coordination cn)
+    ->      detail::buffer_with_time_factory<Coordination> {
+    return  detail::buffer_with_time_factory<Coordination>(period, period, 0, std::move(cn));
+}
+/// emits the values received in a period that starts every skip.
+/// the buffers overlap when skip is shorter than period.
+template<class Coordination>
+inline auto buffer_with_time(rxsc::scheduler::clock_type::duration period, rxsc::scheduler::clock_type::duration skip, Coordination cn)
+    ->      detail::buffer_with_time_factory<Coordination> {
+    return  detail::buffer_with_time_factory<Coordination>(period, skip, 0, std::move(cn));
+}
+/// emits a buffer when it holds count values or when period has passed,
+/// whichever is first
+template<class Coordination>
+inline auto buffer_with_time_or_count(rxsc::scheduler::clock_type::duration period, size_t count, Coordination cn)
+    ->      detail::buffer_with_time_factory<Coordination> {
+    return  detail::buffer_with_time_factory<Coordination>(period, period, std::max<size_t>(count, 1), std::move(cn));
+}
+
+}
+
+}
+
+#endif
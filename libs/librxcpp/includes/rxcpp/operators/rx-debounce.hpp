@@ -0,0 +1,227 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved. See License.txt in the project root for license information.
+
+#pragma once
+
+#if !defined(RXCPP_OPERATORS_RX_DEBOUNCE_HPP)
+#define RXCPP_OPERATORS_RX_DEBOUNCE_HPP
+
+#include "../rx-includes.hpp"
+
+namespace rxcpp {
+
+namespace operators {
+
+namespace detail {
+
+// each value replaces the pending value and moves the deadline. one timer
+// on the coordination's worker is armed by the first value and, when it
+// wakes before the deadline, schedules itself again for the deadline. so
+// a burst of values costs one timer and not one per value.
+template<class T, class Coordination>
+struct debounce
+{
+    typedef typename std::decay<T>::type source_value_type;
+    typedef typename std::decay<Coordination>::type coordination_type;
+    typedef typename coordination_type::coordinator_type coordinator_type;
+    typedef rxsc::scheduler::clock_type clock_type;
+
+    struct debounce_values
+    {
+        debounce_values(clock_type::duration p, coordination_type cn)
+            : period(p)
+            , coordination(std::move(cn))
+        {
+        }
+        clock_type::duration period;
+        coordination_type coordination;
+    };
+
+    debounce_values initial;
+
+    debounce(clock_type::duration period, coordination_type cn)
+        : initial(period, std::move(cn))
+    {
+        // every value would be emitted, there would be no quiet period to wait for
+        if (period <= clock_type::duration::zero()) {
+            throw std::invalid_argument("debounce period must be greater than zero");
+        }
+    }
+
+    template<class Subscriber>
+    struct debounce_observer
+    {
+        typedef debounce_observer<Subscriber> this_type;
+        typedef typename std::decay<Subscriber>::type dest_type;
+        typedef observer<source_value_type, this_type> observer_type;
+
+        struct debounce_state
+            : public timed_state<debounce_values, coordination_type, dest_type>
+            , public std::enable_shared_from_this<debounce_state>
+        {
+            debounce_state(dest_type d, debounce_values v, coordinator_type coor, composite_subscription cs)
+                : timed_state<debounce_values, coordination_type, dest_type>(std::move(d), std::move(v), std::move(coor), std::move(cs))
+                , armed(false)
+                , completed(false)
+            {
+            }
+
+            std::mutex lock;
+            rxu::maybe<source_value_type> pending;
+            clock_type::time_point deadline;
+            // true while the timer is scheduled
+            bool armed;
+            bool completed;
+            std::exception_ptr error;
+
+            rxu::maybe<rxsc::schedulable> timer;
+
+            // must only be called on the worker
+            void tick(const rxsc::schedulable& self) {
+                rxu::maybe<source_value_type> v;
+                bool done = false;
+                std::exception_ptr e;
+                clock_type::time_point wake;
+                {
+                    std::unique_lock<std::mutex> guard(lock);
+                    if (!armed) {
+                        return;
+                    }
+                    wake = deadline;
+                    if (!completed && this->worker.now() < wake) {
+                        guard.unlock();
+                        self.schedule(wake);
+                        return;
+                    }
+                    armed = false;
+                    done = completed;
+                    e = error;
+                    if (!pending.empty() && !e) {
+                        v.reset(std::move(pending.get()));
+                    }
+                    pending.reset();
+                }
+                if (!v.empty()) {
+                    this->dest.on_next(std::move(v.get()));
+                }
+                if (!done) {
+                    return;
+                }
+                if (e) {
+                    this->dest.on_error(e);
+                } else {
+                    this->dest.on_completed();
+                }
+                this->lifetime.unsubscribe();
+            }
+
+            // must be called with lock held
+            void arm(std::unique_lock<std::mutex>& guard, clock_type::time_point when) {
+                if (armed || timer.empty()) {
+                    return;
+                }
+                armed = true;
+                guard.unlock();
+                timer->schedule(when);
+            }
+        };
+        std::shared_ptr<debounce_state> state;
+
+        explicit debounce_observer(std::shared_ptr<debounce_state> s)
+            : state(std::move(s))
+        {
+        }
+
+        void on_next(source_value_type v) const {
+            auto deadline = state->worker.now() + state->values.period;
+            std::unique_lock<std::mutex> guard(state->lock);
+            if (state->completed) {
+                return;
+            }
+            state->pending.reset(std::move(v));
+            state->deadline = deadline;
+            state->arm(guard, deadline);
+        }
+        void on_error(std::exception_ptr e) const {
+            std::unique_lock<std::mutex> guard(state->lock);
+            if (state->completed) {
+                return;
+            }
+            state->completed = true;
+            state->error = e;
+            finish(guard);
+        }
+        void on_completed() const {
+            std::unique_lock<std::mutex> guard(state->lock);
+            if (state->completed) {
+                return;
+            }
+            // the pending value is emitted without waiting for the deadline
+            state->completed = true;
+            finish(guard);
+        }
+
+        // must be called with lock held
+        void finish(std::unique_lock<std::mutex>& guard) const {
+            if (!state->armed) {
+                state->arm(guard, state->worker.now());
+                return;
+            }
+            // the armed timer may be waiting for a later deadline
+            guard.unlock();
+            state->timer->schedule();
+        }
+
+        static subscriber<source_value_type, observer_type> make(dest_type d, debounce_values v) {
+            auto state = make_timed_state<debounce_state>(d, std::move(v));
+
+            state->timer = timed_action(state, [](debounce_state& s, const rxsc::schedulable& self){
+                s.tick(self);
+            });
+
+            return make_subscriber<source_value_type>(d, state->lifetime, observer_type(this_type(state)));
+        }
+    };
+
+    template<class Subscriber>
+    auto operator()(Subscriber dest) const
+        -> decltype(debounce_observer<Subscriber>::make(std::move(dest), initial)) {
+        return      debounce_observer<Subscriber>::make(std::move(dest), initial);
+    }
+};
+
+template<class Coordination>
+class debounce_factory
+{
+    typedef typename std::decay<Coordination>::type coordination_type;
+    typedef rxsc::scheduler::clock_type clock_type;
+
+    clock_type::duration period;
+    coordination_type coordination;
+public:
+    debounce_factory(clock_type::duration p, coordination_type cn)
+        : period(p)
+        , coordination(std::move(cn))
+    {
+    }
+    template<class Observable>
+    auto operator()(Observable&& source)
+        -> decltype(source.template lift<typename std::decay<Observable>::type::value_type>(debounce<typename std::decay<Observable>::type::value_type, Coordination>(period, coordination))) {
+        return      source.template lift<typename std::decay<Observable>::type::value_type>(debounce<typename std::decay<Observable>::type::value_type, Coordination>(period, coordination));
+    }
+};
+
+}
+
+/// emits a value when no other value is received for period after it,
+/// timed on the worker of cn
+template<class Coordination>
+inline auto debounce(rxsc::scheduler::clock_type::duration period, Coordination cn)
+    ->      detail::debounce_factory<Coordination> {
+    return  detail::debounce_factory<Coordination>(period, std::move(cn));
+}
+
+}
+
+}
+
+#endif
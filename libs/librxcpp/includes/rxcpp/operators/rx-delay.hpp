@@ -0,0 +1,252 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved. See License.txt in the project root for license information.
+
+#pragma once
+
+#if !defined(RXCPP_OPERATORS_RX_DELAY_HPP)
+#define RXCPP_OPERATORS_RX_DELAY_HPP
+
+#include "../rx-includes.hpp"
+
+namespace rxcpp {
+
+namespace operators {
+
+namespace detail {
+
+// the values are queued with the time they are due. one timer on the
+// coordination's worker emits the values that are due and schedules itself
+// again for the next one, it is only scheduled by the source when the
+// queue was empty.
+template<class T, class Coordination>
+struct delay
+{
+    typedef typename std::decay<T>::type source_value_type;
+    typedef typename std::decay<Coordination>::type coordination_type;
+    typedef typename coordination_type::coordinator_type coordinator_type;
+    typedef rxsc::scheduler::clock_type clock_type;
+
+    struct delay_values
+    {
+        delay_values(clock_type::duration p, coordination_type cn)
+            : period(p)
+            , coordination(std::move(cn))
+        {
+        }
+        clock_type::duration period;
+        coordination_type coordination;
+    };
+
+    delay_values initial;
+
+    delay(clock_type::duration period, coordination_type cn)
+        : initial(period, std::move(cn))
+    {
+        // observe_on moves values to a worker without delaying them
+        if (period <= clock_type::duration::zero()) {
+            throw std::invalid_argument("delay period must be greater than zero");
+        }
+    }
+
+    template<class Subscriber>
+    struct delay_observer
+    {
+        typedef delay_observer<Subscriber> this_type;
+        typedef typename std::decay<Subscriber>::type dest_type;
+        typedef observer<source_value_type, this_type> observer_type;
+
+        struct delayed_value
+        {
+            delayed_value(clock_type::time_point d, source_value_type v)
+                : due(d)
+                , value(std::move(v))
+            {
+            }
+            clock_type::time_point due;
+            source_value_type value;
+        };
+
+        struct delay_state
+            : public timed_state<delay_values, coordination_type, dest_type>
+            , public std::enable_shared_from_this<delay_state>
+        {
+            delay_state(dest_type d, delay_values v, coordinator_type coor, composite_subscription cs)
+                : timed_state<delay_values, coordination_type, dest_type>(std::move(d), std::move(v), std::move(coor), std::move(cs))
+                , armed(false)
+                , completed(false)
+            {
+            }
+
+            std::mutex lock;
+            std::deque<delayed_value> queue;
+            // true while the timer is scheduled
+            bool armed;
+            bool completed;
+            // when the completion is due
+            clock_type::time_point completed_due;
+            std::exception_ptr error;
+
+            // must only be used on the worker
+            std::vector<source_value_type> batch;
+
+            rxu::maybe<rxsc::schedulable> timer;
+
+            // must only be called on the worker
+            void tick(const rxsc::schedulable& self) {
+                bool done = false;
+                std::exception_ptr e;
+                bool again = false;
+                clock_type::time_point wake;
+                {
+                    std::unique_lock<std::mutex> guard(lock);
+                    if (!armed) {
+                        return;
+                    }
+                    e = error;
+                    if (e) {
+                        // errors are not delayed
+                        queue.clear();
+                        armed = false;
+                        done = true;
+                    } else {
+                        auto now = this->worker.now();
+                        while (!queue.empty() && queue.front().due <= now) {
+                            batch.push_back(std::move(queue.front().value));
+                            queue.pop_front();
+                        }
+                        if (!queue.empty()) {
+                            wake = queue.front().due;
+                            again = true;
+                        } else if (completed && now < completed_due) {
+                            wake = completed_due;
+                            again = true;
+                        } else {
+                            armed = false;
+                            done = completed;
+                        }
+                    }
+                }
+                for (auto& v : batch) {
+                    this->dest.on_next(std::move(v));
+                }
+                batch.clear();
+                if (again) {
+                    self.schedule(wake);
+                    return;
+                }
+                if (!done) {
+                    return;
+                }
+                if (e) {
+                    this->dest.on_error(e);
+                } else {
+                    this->dest.on_completed();
+                }
+                this->lifetime.unsubscribe();
+            }
+
+            // must be called with lock held
+            void arm(std::unique_lock<std::mutex>& guard, clock_type::time_point when) {
+                if (armed || timer.empty()) {
+                    return;
+                }
+                armed = true;
+                guard.unlock();
+                timer->schedule(when);
+            }
+        };
+        std::shared_ptr<delay_state> state;
+
+        explicit delay_observer(std::shared_ptr<delay_state> s)
+            : state(std::move(s))
+        {
+        }
+
+        void on_next(source_value_type v) const {
+            auto due = state->worker.now() + state->values.period;
+            std::unique_lock<std::mutex> guard(state->lock);
+            if (state->completed) {
+                return;
+            }
+            state->queue.push_back(delayed_value(due, std::move(v)));
+            state->arm(guard, due);
+        }
+        void on_error(std::exception_ptr e) const {
+            std::unique_lock<std::mutex> guard(state->lock);
+            if (state->completed) {
+                return;
+            }
+            state->completed = true;
+            state->error = e;
+            if (!state->armed) {
+                state->arm(guard, state->worker.now());
+                return;
+            }
+            // the armed timer may be waiting for a later value
+            guard.unlock();
+            state->timer->schedule();
+        }
+        void on_completed() const {
+            auto due = state->worker.now() + state->values.period;
+            std::unique_lock<std::mutex> guard(state->lock);
+            if (state->completed) {
+                return;
+            }
+            state->completed = true;
+            state->completed_due = due;
+            state->arm(guard, due);
+        }
+
+        static subscriber<source_value_type, observer_type> make(dest_type d, delay_values v) {
+            auto state = make_timed_state<delay_state>(d, std::move(v));
+
+            state->timer = timed_action(state, [](delay_state& s, const rxsc::schedulable& self){
+                s.tick(self);
+            });
+
+            return make_subscriber<source_value_type>(d, state->lifetime, observer_type(this_type(state)));
+        }
+    };
+
+    template<class Subscriber>
+    auto operator()(Subscriber dest) const
+        -> decltype(delay_observer<Subscriber>::make(std::move(dest), initial)) {
+        return      delay_observer<Subscriber>::make(std::move(dest), initial);
+    }
+};
+
+template<class Coordination>
+class delay_factory
+{
+    typedef typename std::decay<Coordination>::type coordination_type;
+    typedef rxsc::scheduler::clock_type clock_type;
+
+    clock_type::duration period;
+    coordination_type coordination;
+public:
+    delay_factory(clock_type::duration p, coordination_type cn)
+        : period(p)
+        , coordination(std::move(cn))
+    {
+    }
+    template<class Observable>
+    auto operator()(Observable&& source)
+        -> decltype(source.template lift<typename std::decay<Observable>::type::value_type>(delay<typename std::decay<Observable>::type::value_type, Coordination>(period, coordination))) {
+        return      source.template lift<typename std::decay<Observable>::type::value_type>(delay<typename std::decay<Observable>::type::value_type, Coordination>(period, coordination));
+    }
+};
+
+}
+
+/// emits each value and the completion period after it is received, timed
+/// on the worker of cn. an error is emitted without a delay.
+template<class Coordination>
+inline auto delay(rxsc::scheduler::clock_type::duration period, Coordination cn)
+    ->      detail::delay_factory<Coordination> {
+    return  detail::delay_factory<Coordination>(period, std::move(cn));
+}
+
+}
+
+}
+
+#endif
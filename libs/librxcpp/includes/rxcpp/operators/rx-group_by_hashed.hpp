@@ -0,0 +1,535 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved. See License.txt in the project root for license information.
+
+#pragma once
+
+#if !defined(RXCPP_OPERATORS_RX_GROUP_BY_HASHED_HPP)
+#define RXCPP_OPERATORS_RX_GROUP_BY_HASHED_HPP
+
+#include "../rx-includes.hpp"
+
+namespace rxcpp {
+
+/// selects when group_by_hashed completes and removes a group.
+/// a group is always removed once every subscriber to it has unsubscribed.
+/// a value for a key that was removed starts a new group.
+/// when group_by_hashed is given a coordination a timer on its worker removes
+/// the idle and released groups on time, also while the source is quiet.
+/// without a coordination the groups are only checked when the source emits,
+/// so a group that went idle is completed by the next value for any key.
+struct group_by_eviction
+{
+    explicit group_by_eviction(rxsc::scheduler::clock_type::duration idle = rxsc::scheduler::clock_type::duration::zero(), size_t max_groups = 0)
+        : idle(idle)
+        , max_groups(max_groups)
+    {
+    }
+    /// a group that has not had a value for this long is removed. zero keeps
+    /// idle groups.
+    rxsc::scheduler::clock_type::duration idle;
+    /// when this many groups exist the group that has been idle the longest
+    /// is removed to make room for a new group. zero is no limit.
+    size_t max_groups;
+};
+
+/// group_by_counters reports the number of groups for every group_by_hashed
+/// that it is passed to.
+class group_by_counters
+{
+    struct state_type
+    {
+        state_type()
+            : active(0)
+            , created(0)
+            , evicted(0)
+        {
+        }
+        std::atomic<size_t> active;
+        std::atomic<size_t> created;
+        std::atomic<size_t> evicted;
+    };
+    std::shared_ptr<state_type> state;
+
+public:
+    group_by_counters()
+        : state(std::make_shared<state_type>())
+    {
+    }
+
+    /// the number of groups that currently exist
+    size_t active() const {
+        return state->active;
+    }
+    /// the number of groups that have been created
+    size_t created() const {
+        return state->created;
+    }
+    /// the number of groups that were removed before the source completed
+    size_t evicted() const {
+        return state->evicted;
+    }
+
+    void created_one() const {
+        ++state->active;
+        ++state->created;
+    }
+    void evicted_one() const {
+        --state->active;
+        ++state->evicted;
+    }
+    void removed(size_t count) const {
+        state->active -= count;
+    }
+};
+
+namespace operators {
+
+namespace detail {
+
+template<class T, class Observable, class KeySelector, class MarbleSelector, class Coordination>
+struct group_by_hashed
+{
+    typedef group_by_traits<T, Observable, KeySelector, MarbleSelector, rxu::less> traits_type;
+    typedef typename traits_type::key_selector_type key_selector_type;
+    typedef typename traits_type::marble_selector_type marble_selector_type;
+    typedef typename traits_type::marble_type marble_type;
+    typedef typename traits_type::subject_type subject_type;
+    typedef typename std::decay<typename traits_type::key_type>::type key_type;
+    typedef grouped_observable<key_type, marble_type> grouped_observable_type;
+    typedef typename std::decay<Coordination>::type coordination_type;
+    typedef rxsc::scheduler::clock_type clock_type;
+
+    struct group_by_values
+    {
+        group_by_values(key_selector_type ks, marble_selector_type ms, group_by_eviction e, group_by_counters c, coordination_type cn, bool t)
+            : keySelector(std::move(ks))
+            , marbleSelector(std::move(ms))
+            , eviction(e)
+            , counters(std::move(c))
+            , coordination(std::move(cn))
+            , timed(t)
+        {
+        }
+        mutable key_selector_type keySelector;
+        mutable marble_selector_type marbleSelector;
+        group_by_eviction eviction;
+        group_by_counters counters;
+        coordination_type coordination;
+        // true when a timer on the coordination removes the idle groups
+        bool timed;
+    };
+
+    group_by_values initial;
+
+    group_by_hashed(key_selector_type ks, marble_selector_type ms, group_by_eviction e, group_by_counters c, coordination_type cn, bool timed)
+        : initial(std::move(ks), std::move(ms), e, std::move(c), std::move(cn), timed)
+    {
+    }
+
+    struct group_by_observable : public rxs::source_base<marble_type>
+    {
+        subject_type subject;
+        key_type key;
+        std::shared_ptr<std::atomic<bool>> subscribed;
+
+        group_by_observable(subject_type s, key_type k, std::shared_ptr<std::atomic<bool>> subscribed)
+            : subject(std::move(s))
+            , key(std::move(k))
+            , subscribed(std::move(subscribed))
+        {
+        }
+
+        template<class Subscriber>
+        void on_subscribe(Subscriber&& o) const {
+            subject.get_observable().subscribe(std::forward<Subscriber>(o));
+            // set after the subscribe so that the group is not seen as
+            // released while the subscriber is being added.
+            *subscribed = true;
+        }
+
+        key_type on_get_key() {
+            return key;
+        }
+    };
+
+    struct group_type
+    {
+        group_type(key_type k, subject_type s, std::shared_ptr<std::atomic<bool>> sd, clock_type::time_point now)
+            : key(std::move(k))
+            , subject(std::move(s))
+            , subscriber(subject.get_subscriber())
+            , subscribed(std::move(sd))
+            , touched(now)
+        {
+        }
+        key_type key;
+        subject_type subject;
+        typename subject_type::subscriber_type subscriber;
+        std::shared_ptr<std::atomic<bool>> subscribed;
+        clock_type::time_point touched;
+
+        bool released() const {
+            return *subscribed && !subject.has_observers();
+        }
+    };
+
+    // open addressing with linear probing. a removed group leaves a
+    // tombstone that is reused by inserts and dropped when the table is
+    // rebuilt.
+    struct group_table
+    {
+        struct slot_type
+        {
+            slot_type()
+                : hash(0)
+                , deleted(false)
+            {
+            }
+            size_t hash;
+            bool deleted;
+            rxu::maybe<group_type> group;
+        };
+
+        static const size_t npos = size_t(-1);
+
+        group_table()
+            : slots(16)
+            , count(0)
+            , tombstones(0)
+        {
+        }
+
+        std::vector<slot_type> slots;
+        size_t count;
+        size_t tombstones;
+
+        size_t mask() const {
+            return slots.size() - 1;
+        }
+
+        size_t find(const key_type& key, size_t hash) const {
+            std::equal_to<key_type> equal;
+            for (size_t i = hash & mask();; i = (i + 1) & mask()) {
+                auto& s = slots[i];
+                if (s.group.empty()) {
+                    if (!s.deleted) {
+                        return npos;
+                    }
+                } else if (s.hash == hash && equal(s.group->key, key)) {
+                    return i;
+                }
+            }
+        }
+
+        size_t insert(size_t hash, group_type g) {
+            if ((count + tombstones + 1) * 4 > slots.size() * 3) {
+                rebuild(count * 2 >= slots.size() ? slots.size() * 2 : slots.size());
+            }
+            for (size_t i = hash & mask();; i = (i + 1) & mask()) {
+                auto& s = slots[i];
+                if (s.group.empty()) {
+                    if (s.deleted) {
+                        s.deleted = false;
+                        --tombstones;
+                    }
+                    s.hash = hash;
+                    s.group.reset(std::move(g));
+                    ++count;
+                    return i;
+                }
+            }
+        }
+
+        void erase(size_t i) {
+            slots[i].group.reset();
+            slots[i].deleted = true;
+            --count;
+            ++tombstones;
+        }
+
+        void rebuild(size_t size) {
+            std::vector<slot_type> old(size);
+            old.swap(slots);
+            tombstones = 0;
+            for (auto& s : old) {
+                if (!s.group.empty()) {
+                    size_t i = s.hash & mask();
+                    while (!slots[i].group.empty()) {
+                        i = (i + 1) & mask();
+                    }
+                    slots[i].hash = s.hash;
+                    slots[i].group.reset(std::move(*s.group));
+                }
+            }
+        }
+    };
+
+    template<class Subscriber>
+    struct group_by_observer : public group_by_values
+    {
+        typedef group_by_observer<Subscriber> this_type;
+        typedef grouped_observable_type value_type;
+        typedef typename std::decay<Subscriber>::type dest_type;
+        typedef observer<T, this_type> observer_type;
+        dest_type dest;
+
+        struct state_type
+        {
+            state_type()
+                : swept(clock_type::now())
+            {
+            }
+            group_table groups;
+            clock_type::time_point swept;
+            // held by the source and the timer while they change the groups
+            // or emit to them. recursive, a group subscriber may cause the
+            // source to emit again on the same thread.
+            std::recursive_mutex lock;
+            rxu::maybe<rxsc::schedulable> timer;
+        };
+        std::shared_ptr<state_type> state;
+
+        group_by_observer(dest_type d, group_by_values v)
+            : group_by_values(std::move(v))
+            , dest(std::move(d))
+            , state(std::make_shared<state_type>())
+        {
+        }
+
+        void evict(size_t i) const {
+            auto subscriber = std::move(state->groups.slots[i].group->subscriber);
+            state->groups.erase(i);
+            this->counters.evicted_one();
+            subscriber.on_completed();
+        }
+
+        bool expired(const group_type& g, clock_type::time_point now) const {
+            return g.released() ||
+                (this->eviction.idle != clock_type::duration::zero() && now - g.touched >= this->eviction.idle);
+        }
+
+        // removes the released and idle groups. runs on the timer, or at
+        // most twice per idle duration without a timer, or when the table is
+        // about to grow. returns when the first remaining group goes idle.
+        clock_type::time_point sweep(clock_type::time_point now) const {
+            state->swept = now;
+            auto next = now + this->eviction.idle;
+            auto& slots = state->groups.slots;
+            for (size_t i = 0; i != slots.size(); ++i) {
+                if (slots[i].group.empty()) {
+                    continue;
+                }
+                if (expired(*slots[i].group, now)) {
+                    evict(i);
+                } else {
+                    next = (std::min)(next, slots[i].group->touched + this->eviction.idle);
+                }
+            }
+            return next;
+        }
+
+        // wakes when the oldest group goes idle
+        void tick(const rxsc::schedulable& self) const {
+            clock_type::time_point next;
+            {
+                std::unique_lock<std::recursive_mutex> guard(state->lock);
+                next = sweep(clock_type::now());
+            }
+            self.schedule(next);
+        }
+
+        // removes the group that has been idle the longest
+        void evict_oldest() const {
+            auto& slots = state->groups.slots;
+            size_t oldest = group_table::npos;
+            for (size_t i = 0; i != slots.size(); ++i) {
+                if (!slots[i].group.empty() &&
+                    (oldest == group_table::npos || slots[i].group->touched < slots[oldest].group->touched)) {
+                    oldest = i;
+                }
+            }
+            if (oldest != group_table::npos) {
+                evict(oldest);
+            }
+        }
+
+        void on_next(T v) const {
+            std::unique_lock<std::recursive_mutex> guard(state->lock, std::defer_lock);
+            if (this->timed) {
+                guard.lock();
+            }
+
+            auto selectedKey = on_exception(
+                [&](){
+                    return this->keySelector(v);},
+                [this](std::exception_ptr e){on_error(e);});
+            if (selectedKey.empty()) {
+                return;
+            }
+            auto& key = selectedKey.get();
+
+            // the time is only needed to find idle groups
+            auto idle = this->eviction.idle != clock_type::duration::zero();
+            auto now = idle || this->eviction.max_groups != 0 ? clock_type::now() : clock_type::time_point();
+            if (idle && !this->timed && now - state->swept >= this->eviction.idle / 2) {
+                sweep(now);
+            }
+
+            auto& groups = state->groups;
+            auto hash = std::hash<key_type>()(key);
+            auto i = groups.find(key, hash);
+            if (i != group_table::npos && groups.slots[i].group->released()) {
+                evict(i);
+                i = group_table::npos;
+            }
+
+            if (i == group_table::npos) {
+                if ((groups.count + groups.tombstones + 1) * 4 > groups.slots.size() * 3) {
+                    // reclaim before growing
+                    sweep(now);
+                }
+                if (this->eviction.max_groups != 0 && groups.count >= this->eviction.max_groups) {
+                    evict_oldest();
+                }
+                auto subscribed = std::make_shared<std::atomic<bool>>(false);
+                subject_type subject;
+                i = groups.insert(hash, group_type(key, subject, subscribed, now));
+                this->counters.created_one();
+                dest.on_next(make_dynamic_grouped_observable<key_type, marble_type>(group_by_observable(std::move(subject), key, std::move(subscribed))));
+            }
+            auto& g = *groups.slots[i].group;
+            g.touched = now;
+
+            auto selectedMarble = on_exception(
+                [&](){
+                    return this->marbleSelector(v);},
+                [this](std::exception_ptr e){on_error(e);});
+            if (selectedMarble.empty()) {
+                return;
+            }
+            g.subscriber.on_next(std::move(selectedMarble.get()));
+        }
+        void on_error(std::exception_ptr e) const {
+            std::unique_lock<std::recursive_mutex> guard(state->lock, std::defer_lock);
+            if (this->timed) {
+                guard.lock();
+            }
+            for(auto& s : state->groups.slots) {
+                if (!s.group.empty()) {
+                    s.group->subscriber.on_error(e);
+                }
+            }
+            this->counters.removed(state->groups.count);
+            state->groups = group_table();
+            dest.on_error(e);
+        }
+        void on_completed() const {
+            std::unique_lock<std::recursive_mutex> guard(state->lock, std::defer_lock);
+            if (this->timed) {
+                guard.lock();
+            }
+            for(auto& s : state->groups.slots) {
+                if (!s.group.empty()) {
+                    s.group->subscriber.on_completed();
+                }
+            }
+            this->counters.removed(state->groups.count);
+            state->groups = group_table();
+            dest.on_completed();
+        }
+
+        static subscriber<T, observer_type> make(dest_type d, group_by_values v) {
+            auto cs = d.get_subscription();
+            this_type o(d, std::move(v));
+            if (o.timed && o.eviction.idle != clock_type::duration::zero()) {
+                // the worker ends with the destination. the timer refers to
+                // the state weakly so that it does not keep the groups alive.
+                auto coordinator = o.coordination.create_coordinator(cs);
+                auto worker = coordinator.get_worker();
+                std::weak_ptr<state_type> weak = o.state;
+                auto sweeper = o;
+                sweeper.state.reset();
+                auto selected = on_exception(
+                    [&](){
+                        return coordinator.act([weak, sweeper](const rxsc::schedulable& self){
+                            auto s = weak.lock();
+                            if (s) {
+                                auto current = sweeper;
+                                current.state = std::move(s);
+                                current.tick(self);
+                            }
+                        });},
+                    d);
+                if (selected.empty()) {
+                    return make_subscriber<T>(std::move(cs), observer_type(std::move(o)));
+                }
+                o.state->timer.reset(rxsc::make_schedulable(worker, selected.get()));
+                o.state->timer->schedule(worker.now() + o.eviction.idle);
+            }
+            return make_subscriber<T>(std::move(cs), observer_type(std::move(o)));
+        }
+    };
+
+    template<class Subscriber>
+    auto operator()(Subscriber dest) const
+        -> decltype(group_by_observer<Subscriber>::make(std::move(dest), initial)) {
+        return      group_by_observer<Subscriber>::make(std::move(dest), initial);
+    }
+};
+
+template<class KeySelector, class MarbleSelector, class Coordination>
+class group_by_hashed_factory
+{
+    typedef typename std::decay<KeySelector>::type key_selector_type;
+    typedef typename std::decay<MarbleSelector>::type marble_selector_type;
+    typedef typename std::decay<Coordination>::type coordination_type;
+    key_selector_type keySelector;
+    marble_selector_type marbleSelector;
+    group_by_eviction eviction;
+    group_by_counters counters;
+    coordination_type coordination;
+    bool timed;
+public:
+    group_by_hashed_factory(key_selector_type ks, marble_selector_type ms, group_by_eviction e, group_by_counters c, coordination_type cn, bool t)
+        : keySelector(std::move(ks))
+        , marbleSelector(std::move(ms))
+        , eviction(e)
+        , counters(std::move(c))
+        , coordination(std::move(cn))
+        , timed(t)
+    {
+    }
+    template<class Observable>
+    struct group_by_hashed_factory_traits
+    {
+        typedef typename std::decay<Observable>::type::value_type value_type;
+        typedef detail::group_by_hashed<value_type, Observable, KeySelector, MarbleSelector, Coordination> group_by_type;
+    };
+    template<class Observable>
+    auto operator()(Observable&& source)
+        -> decltype(source.template lift<typename group_by_hashed_factory_traits<Observable>::group_by_type::grouped_observable_type>(typename group_by_hashed_factory_traits<Observable>::group_by_type(keySelector, marbleSelector, eviction, counters, coordination, timed))) {
+        return      source.template lift<typename group_by_hashed_factory_traits<Observable>::group_by_type::grouped_observable_type>(typename group_by_hashed_factory_traits<Observable>::group_by_type(keySelector, marbleSelector, eviction, counters, coordination, timed));
+    }
+};
+
+}
+
+/// groups are checked for eviction when the source emits
+template<class KeySelector, class MarbleSelector>
+inline auto group_by_hashed(KeySelector ks, MarbleSelector ms, group_by_eviction e = group_by_eviction(), group_by_counters c = group_by_counters())
+    ->      detail::group_by_hashed_factory<KeySelector, MarbleSelector, identity_one_worker> {
+    return  detail::group_by_hashed_factory<KeySelector, MarbleSelector, identity_one_worker>(std::move(ks), std::move(ms), e, std::move(c), identity_immediate(), false);
+}
+
+/// a timer on the worker of cn removes the idle groups on time
+template<class KeySelector, class MarbleSelector, class Coordination>
+inline auto group_by_hashed(KeySelector ks, MarbleSelector ms, group_by_eviction e, Coordination cn, group_by_counters c = group_by_counters())
+    -> typename std::enable_if<is_coordination<Coordination>::value,
+            detail::group_by_hashed_factory<KeySelector, MarbleSelector, Coordination>>::type {
+    return  detail::group_by_hashed_factory<KeySelector, MarbleSelector, Coordination>(std::move(ks), std::move(ms), e, std::move(c), std::move(cn), true);
+}
+
+}
+
+}
+
+#endif
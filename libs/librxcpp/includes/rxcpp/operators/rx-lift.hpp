@@ -62,7 +62,11 @@ struct lift_operator : public operator_base<typename lift_traits<ResultType, Sou
     void on_subscribe(Subscriber o) const {
         auto lifted = chain(std::move(o));
         trace_activity().lift_enter(source, chain, o, lifted);
-        source.on_subscribe(std::move(lifted));
+        // an operator that completed while it was lifted, like take(0) in a
+        // pipe, does not subscribe the source
+        if (lifted.is_subscribed()) {
+            source.on_subscribe(std::move(lifted));
+        }
         trace_activity().lift_return(source, chain);
     }
 };
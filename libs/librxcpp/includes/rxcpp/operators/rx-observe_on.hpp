@@ -37,9 +37,11 @@ struct observe_on
         typedef typename std::decay<Subscriber>::type dest_type;
         typedef observer<value_type, this_type> observer_type;
 
-        typedef rxn::notification<T> notification_type;
-        typedef typename notification_type::type base_notification_type;
-        typedef std::queue<base_notification_type> queue_type;
+        // notifications are held by value in vectors that keep their
+        // capacity, so values that cross threads do not allocate once
+        // the queues have grown to the steady state size.
+        typedef rxn::inline_notification<T> notification_type;
+        typedef std::vector<notification_type> queue_type;
 
         struct mode
         {
@@ -56,6 +58,7 @@ struct observe_on
             mutable std::mutex lock;
             mutable queue_type queue;
             mutable queue_type drain_queue;
+            mutable size_t drain_cursor;
             composite_subscription lifetime;
             rxsc::worker processor;
             mutable typename mode::type current;
@@ -63,7 +66,8 @@ struct observe_on
             dest_type destination;
 
             observe_on_state(dest_type d, coordinator_type coor, composite_subscription cs)
-                : lifetime(std::move(cs))
+                : drain_cursor(0)
+                , lifetime(std::move(cs))
                 , current(mode::Empty)
                 , coordinator(std::move(coor))
                 , destination(std::move(d))
@@ -82,10 +86,10 @@ struct observe_on
                     auto drain = [keepAlive, this](const rxsc::schedulable& self){
                         using std::swap;
                         try {
-                            if (drain_queue.empty() || !destination.is_subscribed()) {
+                            if (drain_cursor == drain_queue.size() || !destination.is_subscribed()) {
                                 std::unique_lock<std::mutex> guard(lock);
                                 if (!destination.is_subscribed() ||
-                                    (!lifetime.is_subscribed() && queue.empty() && drain_queue.empty())) {
+                                    (!lifetime.is_subscribed() && queue.empty() && drain_cursor == drain_queue.size())) {
                                     current = mode::Disposed;
                                     queue_type expired;
                                     swap(expired, queue);
@@ -94,7 +98,9 @@ struct observe_on
                                     destination.unsubscribe();
                                     return;
                                 }
-                                if (drain_queue.empty()) {
+                                if (drain_cursor == drain_queue.size()) {
+                                    drain_queue.clear();
+                                    drain_cursor = 0;
                                     if (queue.empty()) {
                                         current = mode::Empty;
                                         return;
@@ -102,9 +108,7 @@ struct observe_on
                                     swap(queue, drain_queue);
                                 }
                             }
-                            auto notification = std::move(drain_queue.front());
-                            drain_queue.pop();
-                            notification->accept(destination);
+                            drain_queue[drain_cursor++].accept(destination);
                             self();
                         } catch(...) {
                             destination.on_error(std::current_exception());
@@ -145,17 +149,17 @@ struct observe_on
 
         void on_next(source_value_type v) const {
             std::unique_lock<std::mutex> guard(state->lock);
-            state->queue.push(notification_type::on_next(std::move(v)));
+            state->queue.push_back(notification_type::on_next(std::move(v)));
             state->ensure_processing(guard);
         }
         void on_error(std::exception_ptr e) const {
             std::unique_lock<std::mutex> guard(state->lock);
-            state->queue.push(notification_type::on_error(e));
+            state->queue.push_back(notification_type::on_error(e));
             state->ensure_processing(guard);
         }
         void on_completed() const {
             std::unique_lock<std::mutex> guard(state->lock);
-            state->queue.push(notification_type::on_completed());
+            state->queue.push_back(notification_type::on_completed());
             state->ensure_processing(guard);
         }
 
@@ -269,11 +273,26 @@ inline observe_on_one_worker observe_on_event_loop() {
     return r;
 }
 
+inline observe_on_one_worker observe_on_elastic_event_loop() {
+    static observe_on_one_worker r(rxsc::make_elastic_event_loop());
+    return r;
+}
+
 inline observe_on_one_worker observe_on_new_thread() {
     static observe_on_one_worker r(rxsc::make_new_thread());
     return r;
 }
 
+inline observe_on_one_worker observe_on_pooled_thread() {
+    static observe_on_one_worker r(rxsc::make_pooled_thread());
+    return r;
+}
+
+inline observe_on_one_worker observe_on_work_stealing() {
+    static observe_on_one_worker r(rxsc::make_work_stealing());
+    return r;
+}
+
 }
 
 #endif
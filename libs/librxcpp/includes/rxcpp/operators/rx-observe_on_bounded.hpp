@@ -0,0 +1,460 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved. See License.txt in the project root for license information.
+
+#pragma once
+
+#if !defined(RXCPP_OPERATORS_RX_OBSERVE_ON_BOUNDED_HPP)
+#define RXCPP_OPERATORS_RX_OBSERVE_ON_BOUNDED_HPP
+
+#include "../rx-includes.hpp"
+
+namespace rxcpp {
+
+/// selects what observe_on does when its fixed size ring is full.
+struct overflow
+{
+    enum type {
+        /// wait in on_next until the consumer makes room.
+        /// must not be used when the producer runs on the consuming worker.
+        block,
+        /// drop the oldest queued value to make room for the new value.
+        drop_oldest,
+        /// drop the new value.
+        drop_newest,
+        /// drop all the queued values and keep only the new value.
+        keep_latest
+    };
+};
+
+/// observe_on_counters reports the queue depth and the number of dropped
+/// values for every observe_on that it is passed to.
+class observe_on_counters
+{
+    struct state_type
+    {
+        state_type()
+            : depth(0)
+            , high_water(0)
+            , dropped(0)
+        {
+        }
+        std::atomic<size_t> depth;
+        std::atomic<size_t> high_water;
+        std::atomic<size_t> dropped;
+    };
+    std::shared_ptr<state_type> state;
+
+public:
+    observe_on_counters()
+        : state(std::make_shared<state_type>())
+    {
+    }
+
+    /// the number of values currently queued
+    size_t depth() const {
+        return state->depth;
+    }
+    /// the largest number of values that have been queued at once
+    size_t high_water() const {
+        return state->high_water;
+    }
+    /// the number of values that were dropped by the overflow policy
+    size_t dropped() const {
+        return state->dropped;
+    }
+
+    // a value is counted before it is published, so that the consumer
+    // never counts it out first
+    void pushing() const {
+        ++state->depth;
+    }
+    void unpushed() const {
+        --state->depth;
+    }
+    void pushed() const {
+        auto d = state->depth.load();
+        auto h = state->high_water.load();
+        while (d > h && !state->high_water.compare_exchange_weak(h, d)) {
+        }
+    }
+    void popped() const {
+        --state->depth;
+    }
+    void dropped_one() const {
+        --state->depth;
+        ++state->dropped;
+    }
+    void rejected_one() const {
+        ++state->dropped;
+    }
+};
+
+namespace operators {
+
+namespace detail {
+
+// fixed capacity ring of values that are pushed and popped without locks.
+// the cell sequence numbers allow the producer to pop the oldest value to
+// make room while the consumer is popping.
+template<class T>
+class bounded_ring
+{
+    struct cell
+    {
+        std::atomic<size_t> sequence;
+        rxu::maybe<T> value;
+    };
+
+    std::unique_ptr<cell[]> cells;
+    size_t mask;
+    // the cells are a power of two, limit is the capacity that was asked for
+    size_t limit;
+    std::atomic<size_t> enqueue_position;
+    std::atomic<size_t> dequeue_position;
+
+    bounded_ring(const bounded_ring&);
+
+public:
+    explicit bounded_ring(size_t capacity)
+        : mask(0)
+        , limit(std::max(capacity, size_t(1)))
+        , enqueue_position(0)
+        , dequeue_position(0)
+    {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        mask = size - 1;
+        cells.reset(new cell[size]);
+        for (size_t i = 0; i != size; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    size_t capacity() const {
+        return limit;
+    }
+
+    bool empty() const {
+        return enqueue_position.load() == dequeue_position.load();
+    }
+
+    /// moves from v only when the push succeeds
+    bool try_push(T& v) {
+        cell* c = nullptr;
+        size_t position = enqueue_position.load(std::memory_order_relaxed);
+        for (;;) {
+            c = &cells[position & mask];
+            size_t sequence = c->sequence.load(std::memory_order_acquire);
+            auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+            if (difference == 0) {
+                size_t dequeued = dequeue_position.load(std::memory_order_acquire);
+                if (dequeued <= position && position - dequeued >= limit) {
+                    // full at the capacity that was asked for
+                    return false;
+                }
+                if (enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                // full
+                return false;
+            } else {
+                position = enqueue_position.load(std::memory_order_relaxed);
+            }
+        }
+        c->value.reset(std::move(v));
+        c->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_pop(rxu::maybe<T>& out) {
+        cell* c = nullptr;
+        size_t position = dequeue_position.load(std::memory_order_relaxed);
+        for (;;) {
+            c = &cells[position & mask];
+            size_t sequence = c->sequence.load(std::memory_order_acquire);
+            auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position + 1);
+            if (difference == 0) {
+                if (dequeue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                // empty
+                return false;
+            } else {
+                position = dequeue_position.load(std::memory_order_relaxed);
+            }
+        }
+        out.reset(std::move(c->value.get()));
+        c->value.reset();
+        c->sequence.store(position + mask + 1, std::memory_order_release);
+        return true;
+    }
+};
+
+template<class T, class Coordination>
+struct observe_on_bounded
+{
+    typedef typename std::decay<T>::type source_value_type;
+
+    typedef typename std::decay<Coordination>::type coordination_type;
+    typedef typename coordination_type::coordinator_type coordinator_type;
+
+    coordination_type coordination;
+    size_t capacity;
+    overflow::type policy;
+    observe_on_counters counters;
+
+    observe_on_bounded(coordination_type cn, size_t capacity, overflow::type policy, observe_on_counters counters)
+        : coordination(std::move(cn))
+        , capacity(capacity)
+        , policy(policy)
+        , counters(std::move(counters))
+    {
+    }
+
+    template<class Subscriber>
+    struct observe_on_observer
+    {
+        typedef observe_on_observer<Subscriber> this_type;
+        typedef observer_base<source_value_type> base_type;
+        typedef source_value_type value_type;
+        typedef typename std::decay<Subscriber>::type dest_type;
+        typedef observer<value_type, this_type> observer_type;
+
+        struct observe_on_state : std::enable_shared_from_this<observe_on_state>
+        {
+            mutable bounded_ring<value_type> ring;
+            mutable std::atomic<bool> processing;
+            mutable std::atomic<bool> terminated;
+            mutable std::atomic<bool> disposed;
+            // written before terminated is set
+            mutable std::exception_ptr error;
+            overflow::type policy;
+            observe_on_counters counters;
+            composite_subscription lifetime;
+            coordinator_type coordinator;
+            dest_type destination;
+
+            observe_on_state(dest_type d, coordinator_type coor, composite_subscription cs, size_t capacity, overflow::type p, observe_on_counters c)
+                : ring(capacity)
+                , processing(false)
+                , terminated(false)
+                , disposed(false)
+                , policy(p)
+                , counters(std::move(c))
+                , lifetime(std::move(cs))
+                , coordinator(std::move(coor))
+                , destination(std::move(d))
+            {
+            }
+
+            void discard() const {
+                rxu::maybe<value_type> expired;
+                while (ring.try_pop(expired)) {
+                    counters.popped();
+                }
+            }
+
+            void dispose() const {
+                disposed = true;
+                discard();
+                lifetime.unsubscribe();
+                destination.unsubscribe();
+            }
+
+            void push(value_type v) const {
+                if (!lifetime.is_subscribed() || terminated) {
+                    return;
+                }
+                rxu::maybe<value_type> expired;
+                // the number of yields before the block policy sleeps
+                const unsigned spins = 64;
+                for (unsigned attempt = 0;;) {
+                    counters.pushing();
+                    if (ring.try_push(v)) {
+                        break;
+                    }
+                    counters.unpushed();
+                    switch (policy) {
+                    case overflow::drop_newest:
+                        counters.rejected_one();
+                        return;
+                    case overflow::drop_oldest:
+                        if (ring.try_pop(expired)) {
+                            counters.dropped_one();
+                        }
+                        break;
+                    case overflow::keep_latest:
+                        while (ring.try_pop(expired)) {
+                            counters.dropped_one();
+                        }
+                        break;
+                    case overflow::block:
+                        if (!lifetime.is_subscribed() || disposed) {
+                            return;
+                        }
+                        if (attempt < spins) {
+                            ++attempt;
+                            std::this_thread::yield();
+                        } else {
+                            std::this_thread::sleep_for(std::chrono::microseconds(50));
+                        }
+                        break;
+                    default:
+                        abort();
+                    }
+                }
+                counters.pushed();
+                ensure_processing();
+            }
+
+            void ensure_processing() const {
+                if (processing.exchange(true)) {
+                    return;
+                }
+                if (disposed) {
+                    return;
+                }
+
+                auto keepAlive = this->shared_from_this();
+
+                auto drain = [keepAlive, this](const rxsc::schedulable& self){
+                    try {
+                        if (!destination.is_subscribed()) {
+                            dispose();
+                            return;
+                        }
+                        rxu::maybe<value_type> next;
+                        if (ring.try_pop(next)) {
+                            counters.popped();
+                            destination.on_next(std::move(next.get()));
+                            self();
+                            return;
+                        }
+                        if (terminated) {
+                            // a value pushed before the terminal notification
+                            // may not have been visible to the pop above.
+                            if (ring.try_pop(next)) {
+                                counters.popped();
+                                destination.on_next(std::move(next.get()));
+                                self();
+                                return;
+                            }
+                            if (error) {
+                                destination.on_error(error);
+                            } else {
+                                destination.on_completed();
+                            }
+                            dispose();
+                            return;
+                        }
+                        if (!lifetime.is_subscribed()) {
+                            dispose();
+                            return;
+                        }
+                        processing = false;
+                        // a value may have been pushed after the ring was found empty
+                        if ((!ring.empty() || terminated) && !processing.exchange(true)) {
+                            self();
+                        }
+                    } catch(...) {
+                        destination.on_error(std::current_exception());
+                        dispose();
+                    }
+                };
+
+                auto selectedDrain = on_exception(
+                    [&](){return coordinator.act(drain);},
+                    destination);
+                if (selectedDrain.empty()) {
+                    dispose();
+                    return;
+                }
+
+                auto processor = coordinator.get_worker();
+                processor.schedule(selectedDrain.get());
+            }
+        };
+        std::shared_ptr<observe_on_state> state;
+
+        observe_on_observer(dest_type d, coordinator_type coor, composite_subscription cs, size_t capacity, overflow::type policy, observe_on_counters counters)
+            : state(std::make_shared<observe_on_state>(std::move(d), std::move(coor), std::move(cs), capacity, policy, std::move(counters)))
+        {
+        }
+
+        void on_next(source_value_type v) const {
+            state->push(std::move(v));
+        }
+        void on_error(std::exception_ptr e) const {
+            if (!state->terminated) {
+                state->error = e;
+                state->terminated = true;
+                state->ensure_processing();
+            }
+        }
+        void on_completed() const {
+            if (!state->terminated) {
+                state->terminated = true;
+                state->ensure_processing();
+            }
+        }
+
+        static subscriber<value_type, observer<value_type, this_type>> make(dest_type d, coordination_type cn, size_t capacity, overflow::type policy, observe_on_counters counters, composite_subscription cs = composite_subscription()) {
+            auto coor = cn.create_coordinator(d.get_subscription());
+            d.add(cs);
+
+            this_type o(d, std::move(coor), cs, capacity, policy, std::move(counters));
+            auto keepAlive = o.state;
+            cs.add([keepAlive](){
+                keepAlive->ensure_processing();
+            });
+
+            return make_subscriber<value_type>(d, cs, make_observer<value_type>(std::move(o)));
+        }
+    };
+
+    template<class Subscriber>
+    auto operator()(Subscriber dest) const
+        -> decltype(observe_on_observer<decltype(dest.as_dynamic())>::make(dest.as_dynamic(), coordination, capacity, policy, counters)) {
+        return      observe_on_observer<decltype(dest.as_dynamic())>::make(dest.as_dynamic(), coordination, capacity, policy, counters);
+    }
+};
+
+template<class Coordination>
+class observe_on_bounded_factory
+{
+    typedef typename std::decay<Coordination>::type coordination_type;
+    coordination_type coordination;
+    size_t capacity;
+    overflow::type policy;
+    observe_on_counters counters;
+public:
+    observe_on_bounded_factory(coordination_type cn, size_t capacity, overflow::type policy, observe_on_counters counters)
+        : coordination(std::move(cn))
+        , capacity(capacity)
+        , policy(policy)
+        , counters(std::move(counters))
+    {
+    }
+    template<class Observable>
+    auto operator()(Observable&& source)
+        -> decltype(source.template lift<typename std::decay<Observable>::type::value_type>(observe_on_bounded<typename std::decay<Observable>::type::value_type, coordination_type>(coordination, capacity, policy, counters))) {
+        return      source.template lift<typename std::decay<Observable>::type::value_type>(observe_on_bounded<typename std::decay<Observable>::type::value_type, coordination_type>(coordination, capacity, policy, counters));
+    }
+};
+
+}
+
+template<class Coordination>
+auto observe_on(Coordination cn, size_t capacity, overflow::type policy, observe_on_counters counters = observe_on_counters())
+    ->      detail::observe_on_bounded_factory<Coordination> {
+    return  detail::observe_on_bounded_factory<Coordination>(std::move(cn), capacity, policy, std::move(counters));
+}
+
+}
+
+}
+
+#endif
@@ -0,0 +1,485 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved. See License.txt in the project root for license information.
+
+#pragma once
+
+#if !defined(RXCPP_OPERATORS_RX_PIPE_HPP)
+#define RXCPP_OPERATORS_RX_PIPE_HPP
+
+#include "../rx-includes.hpp"
+// the scan stage accumulates the same way as scan and reduce
+#include "rx-reduce.hpp"
+
+namespace rxcpp {
+
+namespace operators {
+
+namespace detail {
+
+// a pipe is a list of stages that is applied with one lift. the stages are
+// bound into nested nodes at compile time, each node calls the next one
+// directly, so a value passes through one subscriber for the whole chain
+// instead of one subscriber for each operator.
+//
+// a stage spec is copied into each subscription and provides
+//     template<class In> struct stage {
+//         typedef ... value_type;
+//         explicit stage(const spec&);
+//         template<class V, class Next> void on_next(V&& v, const Next& next);
+//     };
+// a stage may call next.on_next, next.on_error and next.on_completed.
+// a stage may also provide
+//     template<class Next> void on_start(const Next& next);
+// which is called when the pipe is subscribed, before any value. a stage
+// without it passes the start to the next stage.
+
+struct pipe_end
+{
+};
+
+template<class Spec, class Before>
+struct pipe_link
+{
+    pipe_link(Before b, Spec s)
+        : before(std::move(b))
+        , spec(std::move(s))
+    {
+    }
+    Before before;
+    Spec spec;
+};
+
+// the type of the values that leave the stages when T enters them
+template<class Stages, class T>
+struct pipe_output;
+template<class T>
+struct pipe_output<pipe_end, T>
+{
+    typedef T type;
+};
+template<class Spec, class Before, class T>
+struct pipe_output<pipe_link<Spec, Before>, T>
+{
+    typedef typename pipe_output<Before, T>::type input_type;
+    typedef typename Spec::template stage<input_type> stage_type;
+    typedef typename stage_type::value_type type;
+};
+
+template<class Stage, class Next>
+auto pipe_start(Stage& stage, const Next& next, int)
+    -> decltype(stage.on_start(next)) {
+    return      stage.on_start(next);
+}
+template<class Stage, class Next>
+void pipe_start(Stage&, const Next& next, ...) {
+    next.on_start();
+}
+
+template<class Stage, class Next>
+struct pipe_node
+{
+    pipe_node(Stage s, Next n)
+        : stage(std::move(s))
+        , next(std::move(n))
+    {
+    }
+    mutable Stage stage;
+    Next next;
+
+    void on_start() const {
+        pipe_start(stage, next, 0);
+    }
+    template<class V>
+    void on_next(V&& v) const {
+        stage.on_next(std::forward<V>(v), next);
+    }
+    void on_error(std::exception_ptr e) const {
+        next.on_error(e);
+    }
+    void on_completed() const {
+        next.on_completed();
+    }
+};
+
+// binds the stages, from the last to the first, in front of Sink
+template<class Stages, class T, class Sink>
+struct pipe_bind;
+template<class T, class Sink>
+struct pipe_bind<pipe_end, T, Sink>
+{
+    typedef Sink type;
+    static type make(const pipe_end&, Sink sink) {
+        return sink;
+    }
+};
+template<class Spec, class Before, class T, class Sink>
+struct pipe_bind<pipe_link<Spec, Before>, T, Sink>
+{
+    typedef typename pipe_output<pipe_link<Spec, Before>, T>::stage_type stage_type;
+    typedef pipe_node<stage_type, Sink> node_type;
+    typedef pipe_bind<Before, T, node_type> before_type;
+    typedef typename before_type::type type;
+    static type make(const pipe_link<Spec, Before>& link, Sink sink) {
+        return before_type::make(link.before, node_type(stage_type(link.spec), std::move(sink)));
+    }
+};
+
+template<class Selector>
+struct pipe_map
+{
+    typedef typename std::decay<Selector>::type select_type;
+    select_type selector;
+
+    explicit pipe_map(select_type s)
+        : selector(std::move(s))
+    {
+    }
+
+    template<class In>
+    struct stage
+    {
+        typedef typename std::decay<decltype((*(select_type*)nullptr)(*(In*)nullptr))>::type value_type;
+        select_type selector;
+
+        explicit stage(const pipe_map& spec)
+            : selector(spec.selector)
+        {
+        }
+        template<class V, class Next>
+        void on_next(V&& v, const Next& next) {
+            auto selected = on_exception(
+                [&](){return this->selector(std::forward<V>(v));},
+                [&](std::exception_ptr e){next.on_error(e);});
+            if (selected.empty()) {
+                return;
+            }
+            next.on_next(std::move(selected.get()));
+        }
+    };
+};
+
+template<class Predicate>
+struct pipe_filter
+{
+    typedef typename std::decay<Predicate>::type test_type;
+    test_type test;
+
+    explicit pipe_filter(test_type t)
+        : test(std::move(t))
+    {
+    }
+
+    template<class In>
+    struct stage
+    {
+        typedef In value_type;
+        test_type test;
+
+        explicit stage(const pipe_filter& spec)
+            : test(spec.test)
+        {
+        }
+        template<class V, class Next>
+        void on_next(V&& v, const Next& next) {
+            auto filtered = on_exception(
+                [&](){return !this->test(static_cast<const value_type&>(v));},
+                [&](std::exception_ptr e){next.on_error(e);});
+            if (filtered.empty() || filtered.get()) {
+                return;
+            }
+            next.on_next(std::forward<V>(v));
+        }
+    };
+};
+
+struct pipe_skip
+{
+    int count;
+
+    explicit pipe_skip(int c)
+        : count(c)
+    {
+    }
+
+    template<class In>
+    struct stage
+    {
+        typedef In value_type;
+        int remaining;
+
+        explicit stage(const pipe_skip& spec)
+            : remaining(spec.count)
+        {
+        }
+        template<class V, class Next>
+        void on_next(V&& v, const Next& next) {
+            if (remaining > 0) {
+                --remaining;
+                return;
+            }
+            next.on_next(std::forward<V>(v));
+        }
+    };
+};
+
+struct pipe_take
+{
+    int count;
+
+    explicit pipe_take(int c)
+        : count(c)
+    {
+    }
+
+    template<class In>
+    struct stage
+    {
+        typedef In value_type;
+        int remaining;
+
+        explicit stage(const pipe_take& spec)
+            : remaining(spec.count)
+        {
+        }
+        // take(0) completes without waiting for a value, as take does.
+        // the source is not subscribed after the completion.
+        template<class Next>
+        void on_start(const Next& next) {
+            if (remaining <= 0) {
+                next.on_completed();
+                return;
+            }
+            next.on_start();
+        }
+        template<class V, class Next>
+        void on_next(V&& v, const Next& next) {
+            next.on_next(std::forward<V>(v));
+            if (--remaining == 0) {
+                next.on_completed();
+            }
+        }
+    };
+};
+
+struct pipe_distinct_until_changed
+{
+    template<class In>
+    struct stage
+    {
+        typedef In value_type;
+        rxu::detail::maybe<value_type> remembered;
+
+        explicit stage(const pipe_distinct_until_changed&)
+        {
+        }
+        template<class V, class Next>
+        void on_next(V&& v, const Next& next) {
+            if (!remembered.empty() && v == remembered.get()) {
+                return;
+            }
+            remembered.reset(v);
+            next.on_next(std::forward<V>(v));
+        }
+    };
+};
+
+template<class Seed, class Accumulator>
+struct pipe_scan
+{
+    typedef typename std::decay<Seed>::type seed_type;
+    typedef typename std::decay<Accumulator>::type accumulator_type;
+    seed_type seed;
+    accumulator_type accumulator;
+
+    pipe_scan(seed_type s, accumulator_type a)
+        : seed(std::move(s))
+        , accumulator(std::move(a))
+    {
+    }
+
+    template<class In>
+    struct stage
+    {
+        typedef seed_type value_type;
+        typedef std::integral_constant<bool, is_accumulate_in_place<In, seed_type, accumulator_type>::value> in_place;
+        seed_type result;
+        accumulator_type accumulator;
+
+        static_assert(is_accumulate_function_for<In, seed_type, accumulator_type>::value, "pipe scan Accumulator must be a function with the signature Seed(Seed, T) or void(Seed&, T)");
+
+        explicit stage(const pipe_scan& spec)
+            : result(spec.seed)
+            , accumulator(spec.accumulator)
+        {
+        }
+        template<class V, class Next>
+        void on_next(V&& v, const Next& next) {
+            if (!accumulate(result, accumulator, std::forward<V>(v), next, in_place())) {
+                return;
+            }
+            next.on_next(result);
+        }
+    };
+};
+
+template<class T, class Stages>
+struct pipe
+{
+    typedef typename std::decay<T>::type source_value_type;
+    typedef typename pipe_output<Stages, source_value_type>::type value_type;
+
+    Stages stages;
+
+    explicit pipe(Stages s)
+        : stages(std::move(s))
+    {
+    }
+
+    template<class Subscriber>
+    struct pipe_sink
+    {
+        typedef typename std::decay<Subscriber>::type dest_type;
+        dest_type dest;
+        composite_subscription lifetime;
+
+        pipe_sink(dest_type d, composite_subscription cs)
+            : dest(std::move(d))
+            , lifetime(std::move(cs))
+        {
+        }
+        void on_start() const {
+        }
+        template<class V>
+        void on_next(V&& v) const {
+            dest.on_next(std::forward<V>(v));
+        }
+        void on_error(std::exception_ptr e) const {
+            lifetime.unsubscribe();
+            dest.on_error(e);
+        }
+        void on_completed() const {
+            // must shutdown source before signaling completion
+            lifetime.unsubscribe();
+            dest.on_completed();
+        }
+    };
+
+    template<class Subscriber>
+    struct pipe_observer
+    {
+        typedef pipe_observer<Subscriber> this_type;
+        typedef typename std::decay<Subscriber>::type dest_type;
+        typedef observer<source_value_type, this_type> observer_type;
+        typedef pipe_bind<Stages, source_value_type, pipe_sink<Subscriber>> bind_type;
+        typedef typename bind_type::type chain_type;
+
+        chain_type chain;
+
+        explicit pipe_observer(chain_type c)
+            : chain(std::move(c))
+        {
+        }
+        void on_next(source_value_type v) const {
+            chain.on_next(std::move(v));
+        }
+        void on_error(std::exception_ptr e) const {
+            chain.on_error(e);
+        }
+        void on_completed() const {
+            chain.on_completed();
+        }
+
+        static subscriber<source_value_type, observer_type> make(dest_type d, const Stages& stages) {
+            // the source is unsubscribed before take completes the destination
+            auto cs = composite_subscription();
+            d.add(cs);
+            this_type o(bind_type::make(stages, pipe_sink<Subscriber>(d, cs)));
+            o.chain.on_start();
+            return make_subscriber<source_value_type>(d, cs, observer_type(std::move(o)));
+        }
+    };
+
+    template<class Subscriber>
+    auto operator()(Subscriber dest) const
+        -> decltype(pipe_observer<Subscriber>::make(std::move(dest), stages)) {
+        return      pipe_observer<Subscriber>::make(std::move(dest), stages);
+    }
+};
+
+template<class Stages>
+class pipe_factory
+{
+    Stages stages;
+
+    template<class Spec>
+    pipe_factory<pipe_link<Spec, Stages>> then(Spec spec) const {
+        return pipe_factory<pipe_link<Spec, Stages>>(pipe_link<Spec, Stages>(stages, std::move(spec)));
+    }
+public:
+    explicit pipe_factory(Stages s)
+        : stages(std::move(s))
+    {
+    }
+
+    /// map ->
+    /// for each value, emits the result of selector.
+    ///
+    template<class Selector>
+    pipe_factory<pipe_link<pipe_map<Selector>, Stages>> map(Selector s) const {
+        return then(pipe_map<Selector>(std::move(s)));
+    }
+    /// filter ->
+    /// emits the values for which predicate returns true.
+    ///
+    template<class Predicate>
+    pipe_factory<pipe_link<pipe_filter<Predicate>, Stages>> filter(Predicate p) const {
+        return then(pipe_filter<Predicate>(std::move(p)));
+    }
+    /// skip ->
+    /// drops the first count values.
+    ///
+    pipe_factory<pipe_link<pipe_skip, Stages>> skip(int count) const {
+        return then(pipe_skip(count));
+    }
+    /// take ->
+    /// emits the first count values and completes.
+    ///
+    pipe_factory<pipe_link<pipe_take, Stages>> take(int count) const {
+        return then(pipe_take(count));
+    }
+    /// distinct_until_changed ->
+    /// drops the values that are equal to the previous value.
+    ///
+    pipe_factory<pipe_link<pipe_distinct_until_changed, Stages>> distinct_until_changed() const {
+        return then(pipe_distinct_until_changed());
+    }
+    /// scan ->
+    /// emits each result of Accumulator, which is either Seed(Seed, T) or void(Seed&, T).
+    ///
+    template<class Seed, class Accumulator>
+    pipe_factory<pipe_link<pipe_scan<Seed, Accumulator>, Stages>> scan(Seed seed, Accumulator a) const {
+        return then(pipe_scan<Seed, Accumulator>(std::move(seed), std::move(a)));
+    }
+
+    template<class Observable>
+    auto operator()(Observable&& source)
+        -> decltype(source.template lift<typename pipe<typename std::decay<Observable>::type::value_type, Stages>::value_type>(pipe<typename std::decay<Observable>::type::value_type, Stages>(stages))) {
+        return      source.template lift<typename pipe<typename std::decay<Observable>::type::value_type, Stages>::value_type>(pipe<typename std::decay<Observable>::type::value_type, Stages>(stages));
+    }
+};
+
+}
+
+/// starts a chain of synchronous operators that is applied as one operator.
+///
+///     values | rxo::pipe().map(f).filter(p).distinct_until_changed()
+///
+inline auto pipe()
+    ->      detail::pipe_factory<detail::pipe_end> {
+    return  detail::pipe_factory<detail::pipe_end>(detail::pipe_end());
+}
+
+}
+
+}
+
+#endif
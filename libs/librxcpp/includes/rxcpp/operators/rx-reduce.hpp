@@ -26,10 +26,77 @@ struct is_accumulate_function_for {
     template<class CS, class CV, class CRS>
     static tag_not_valid check(...);
 
+    template<class CS, class CV, class CRS>
+    static auto check_rvalue(int) -> decltype((*(CRS*)nullptr)(std::move(*(CS*)nullptr), *(CV*)nullptr));
+    template<class CS, class CV, class CRS>
+    static tag_not_valid check_rvalue(...);
+
     typedef decltype(check<seed_type, source_value_type, accumulator_type>(0)) type;
-    static const bool value = std::is_same<type, seed_type>::value;
+    // a void accumulator that also accepts an rvalue seed takes it by value
+    // or by const&, it would update a copy and lose every value
+    static const bool in_place = std::is_same<type, void>::value &&
+        std::is_same<decltype(check_rvalue<seed_type, source_value_type, accumulator_type>(0)), tag_not_valid>::value;
+    static const bool value = std::is_same<type, seed_type>::value || in_place;
+};
+
+/// true when Accumulator has the signature void(Seed&, T) and updates the seed in place
+template<class T, class Seed, class Accumulator>
+struct is_accumulate_in_place {
+    typedef typename is_accumulate_function_for<T, Seed, Accumulator>::type type;
+    static const bool value = is_accumulate_function_for<T, Seed, Accumulator>::in_place;
 };
 
+// the seed is moved through an accumulator that accepts an rvalue. a
+// Seed(Seed&, T) accumulator cannot bind an rvalue and is passed the seed.
+template<class Accumulator, class Seed, class V>
+auto accumulate_next(Accumulator& a, Seed& seed, V&& v, int)
+    -> decltype(a(std::move(seed), std::forward<V>(v))) {
+    return      a(std::move(seed), std::forward<V>(v));
+}
+template<class Accumulator, class Seed, class V>
+auto accumulate_next(Accumulator& a, Seed& seed, V&& v, ...)
+    -> decltype(a(seed, std::forward<V>(v))) {
+    return      a(seed, std::forward<V>(v));
+}
+
+// folds v into seed. a Seed(Seed, T) accumulator has the seed moved
+// through it and a void(Seed&, T) accumulator updates it in place, so a
+// seed that owns storage is not copied for each value. returns false when
+// the accumulator threw and the error was sent to out. out only
+// needs on_error.
+template<class Seed, class Accumulator, class V, class Subscriber>
+bool accumulate(Seed& seed, Accumulator& a, V&& v, const Subscriber& out, std::true_type) {
+    try {
+        a(seed, std::forward<V>(v));
+    } catch (...) {
+        out.on_error(std::current_exception());
+        return false;
+    }
+    return true;
+}
+template<class Seed, class Accumulator, class V, class Subscriber>
+bool accumulate(Seed& seed, Accumulator& a, V&& v, const Subscriber& out, std::false_type) {
+    try {
+        seed = accumulate_next(a, seed, std::forward<V>(v), 0);
+    } catch (...) {
+        out.on_error(std::current_exception());
+        return false;
+    }
+    return true;
+}
+
+// the seed is not used again after the result is selected
+template<class ResultSelector, class Seed>
+auto select_result(ResultSelector& rs, Seed& seed, int)
+    -> decltype(rs(std::move(seed))) {
+    return      rs(std::move(seed));
+}
+template<class ResultSelector, class Seed>
+auto select_result(ResultSelector& rs, Seed& seed, ...)
+    -> decltype(rs(seed)) {
+    return      rs(seed);
+}
+
 template<class Seed, class ResultSelector>
 struct is_result_function_for {
 
@@ -57,7 +124,7 @@ struct reduce_traits
 
     typedef T source_value_type;
 
-    static_assert(is_accumulate_function_for<source_value_type, seed_type, accumulator_type>::value, "reduce Accumulator must be a function with the signature Seed(Seed, reduce::source_value_type)");
+    static_assert(is_accumulate_function_for<source_value_type, seed_type, accumulator_type>::value, "reduce Accumulator must be a function with the signature Seed(Seed, reduce::source_value_type) or void(Seed&, reduce::source_value_type)");
 
     static_assert(is_result_function_for<seed_type, result_selector_type>::value, "reduce ResultSelector must be a function with the signature reduce::value_type(Seed)");
 
@@ -111,8 +178,8 @@ struct reduce : public operator_base<typename reduce_traits<T, SourceOperator, A
             , public std::enable_shared_from_this<reduce_state_type>
         {
             reduce_state_type(reduce_initial_type i, Subscriber scrbr)
-                : reduce_initial_type(i)
-                , source(i.source)
+                : reduce_initial_type(std::move(i))
+                , source(reduce_initial_type::source)
                 , current(reduce_initial_type::seed)
                 , out(std::move(scrbr))
             {
@@ -126,13 +193,8 @@ struct reduce : public operator_base<typename reduce_traits<T, SourceOperator, A
             state->out,
         // on_next
             [state](T t) {
-                auto next = on_exception(
-                    [&](){return state->accumulator(state->current, t);},
-                    state->out);
-                if (next.empty()) {
-                    return;
-                }
-                state->current = next.get();
+                accumulate(state->current, state->accumulator, std::move(t), state->out,
+                    std::integral_constant<bool, is_accumulate_in_place<T, seed_type, accumulator_type>::value>());
             },
         // on_error
             [state](std::exception_ptr e) {
@@ -141,7 +203,7 @@ struct reduce : public operator_base<typename reduce_traits<T, SourceOperator, A
         // on_completed
             [state]() {
                 auto result = on_exception(
-                    [&](){return state->result_selector(state->current);},
+                    [&](){return select_result(state->result_selector, state->current, 0);},
                     state->out);
                 if (result.empty()) {
                     return;
@@ -0,0 +1,185 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved. See License.txt in the project root for license information.
+
+#pragma once
+
+#if !defined(RXCPP_OPERATORS_RX_SAMPLE_HPP)
+#define RXCPP_OPERATORS_RX_SAMPLE_HPP
+
+#include "../rx-includes.hpp"
+
+namespace rxcpp {
+
+namespace operators {
+
+namespace detail {
+
+// the source only replaces the latest value. one periodic timer on the
+// coordination's worker emits it when it changed since the last period.
+template<class T, class Coordination>
+struct sample
+{
+    typedef typename std::decay<T>::type source_value_type;
+    typedef typename std::decay<Coordination>::type coordination_type;
+    typedef typename coordination_type::coordinator_type coordinator_type;
+    typedef rxsc::scheduler::clock_type clock_type;
+
+    struct sample_values
+    {
+        sample_values(clock_type::duration p, coordination_type cn)
+            : period(p)
+            , coordination(std::move(cn))
+        {
+        }
+        clock_type::duration period;
+        coordination_type coordination;
+    };
+
+    sample_values initial;
+
+    sample(clock_type::duration period, coordination_type cn)
+        : initial(period, std::move(cn))
+    {
+        // the sampling timer would repeat without time passing
+        if (period <= clock_type::duration::zero()) {
+            throw std::invalid_argument("sample period must be greater than zero");
+        }
+    }
+
+    template<class Subscriber>
+    struct sample_observer
+    {
+        typedef sample_observer<Subscriber> this_type;
+        typedef typename std::decay<Subscriber>::type dest_type;
+        typedef observer<source_value_type, this_type> observer_type;
+
+        struct sample_state
+            : public timed_state<sample_values, coordination_type, dest_type>
+            , public std::enable_shared_from_this<sample_state>
+        {
+            sample_state(dest_type d, sample_values v, coordinator_type coor, composite_subscription cs)
+                : timed_state<sample_values, coordination_type, dest_type>(std::move(d), std::move(v), std::move(coor), std::move(cs))
+                , completed(false)
+            {
+            }
+
+            std::mutex lock;
+            rxu::maybe<source_value_type> latest;
+            bool completed;
+
+            // must only be called on the worker
+            void emit() {
+                rxu::maybe<source_value_type> v;
+                {
+                    std::unique_lock<std::mutex> guard(lock);
+                    if (latest.empty()) {
+                        return;
+                    }
+                    v.reset(std::move(latest.get()));
+                    latest.reset();
+                }
+                this->dest.on_next(std::move(v.get()));
+            }
+        };
+        std::shared_ptr<sample_state> state;
+
+        explicit sample_observer(std::shared_ptr<sample_state> s)
+            : state(std::move(s))
+        {
+        }
+
+        void on_next(source_value_type v) const {
+            std::unique_lock<std::mutex> guard(state->lock);
+            if (state->completed) {
+                return;
+            }
+            state->latest.reset(std::move(v));
+        }
+        void on_error(std::exception_ptr e) const {
+            {
+                std::unique_lock<std::mutex> guard(state->lock);
+                if (state->completed) {
+                    return;
+                }
+                state->completed = true;
+            }
+            auto keepAlive = state;
+            state->schedule([keepAlive, e](const rxsc::schedulable&){
+                keepAlive->dest.on_error(e);
+                keepAlive->lifetime.unsubscribe();
+            });
+        }
+        void on_completed() const {
+            {
+                std::unique_lock<std::mutex> guard(state->lock);
+                if (state->completed) {
+                    return;
+                }
+                state->completed = true;
+            }
+            // the value received since the last period is not dropped
+            auto keepAlive = state;
+            state->schedule([keepAlive](const rxsc::schedulable&){
+                keepAlive->emit();
+                keepAlive->dest.on_completed();
+                keepAlive->lifetime.unsubscribe();
+            });
+        }
+
+        static subscriber<source_value_type, observer_type> make(dest_type d, sample_values v) {
+            auto state = make_timed_state<sample_state>(d, std::move(v));
+
+            auto tick = timed_action(state, [](sample_state& s, const rxsc::schedulable&){
+                s.emit();
+            });
+            if (!tick.empty()) {
+                auto period = state->values.period;
+                state->worker.schedule_periodically(state->worker.now() + period, period, tick.get());
+            }
+
+            return make_subscriber<source_value_type>(d, state->lifetime, observer_type(this_type(state)));
+        }
+    };
+
+    template<class Subscriber>
+    auto operator()(Subscriber dest) const
+        -> decltype(sample_observer<Subscriber>::make(std::move(dest), initial)) {
+        return      sample_observer<Subscriber>::make(std::move(dest), initial);
+    }
+};
+
+template<class Coordination>
+class sample_factory
+{
+    typedef typename std::decay<Coordination>::type coordination_type;
+    typedef rxsc::scheduler::clock_type clock_type;
+
+    clock_type::duration period;
+    coordination_type coordination;
+public:
+    sample_factory(clock_type::duration p, coordination_type cn)
+        : period(p)
+        , coordination(std::move(cn))
+    {
+    }
+    template<class Observable>
+    auto operator()(Observable&& source)
+        -> decltype(source.template lift<typename std::decay<Observable>::type::value_type>(sample<typename std::decay<Observable>::type::value_type, Coordination>(period, coordination))) {
+        return      source.template lift<typename std::decay<Observable>::type::value_type>(sample<typename std::decay<Observable>::type::value_type, Coordination>(period, coordination));
+    }
+};
+
+}
+
+/// emits the most recent value at the end of each period in which a value
+/// was received, timed on the worker of cn
+template<class Coordination>
+inline auto sample(rxsc::scheduler::clock_type::duration period, Coordination cn)
+    ->      detail::sample_factory<Coordination> {
+    return  detail::sample_factory<Coordination>(period, std::move(cn));
+}
+
+}
+
+}
+
+#endif
@@ -25,7 +25,7 @@ struct scan : public operator_base<typename std::decay<Seed>::type>
         scan_initial_type(source_type o, accumulator_type a, seed_type s)
             : source(std::move(o))
             , accumulator(std::move(a))
-            , seed(s)
+            , seed(std::move(s))
         {
         }
         source_type source;
@@ -34,15 +34,20 @@ struct scan : public operator_base<typename std::decay<Seed>::type>
     };
     scan_initial_type initial;
 
+    struct tag_not_valid {};
     template<class CT, class CS, class CP>
     static auto check(int) -> decltype((*(CP*)nullptr)(*(CS*)nullptr, *(CT*)nullptr));
     template<class CT, class CS, class CP>
-    static void check(...);
+    static tag_not_valid check(...);
+
+    typedef decltype(check<T, seed_type, accumulator_type>(0)) accumulate_result_type;
+    // void(Seed&, T) updates the seed in place
+    typedef std::integral_constant<bool, is_accumulate_in_place<T, seed_type, accumulator_type>::value> in_place;
 
     scan(source_type o, accumulator_type a, seed_type s)
-        : initial(std::move(o), a, s)
+        : initial(std::move(o), std::move(a), std::move(s))
     {
-        static_assert(std::is_convertible<decltype(check<T, seed_type, accumulator_type>(0)), seed_type>::value, "scan Accumulator must be a function with the signature Seed(Seed, T)");
+        static_assert(in_place::value || std::is_convertible<accumulate_result_type, seed_type>::value, "scan Accumulator must be a function with the signature Seed(Seed, T) or void(Seed&, T)");
     }
     template<class Subscriber>
     void on_subscribe(Subscriber o) {
@@ -51,7 +56,7 @@ struct scan : public operator_base<typename std::decay<Seed>::type>
             , public std::enable_shared_from_this<scan_state_type>
         {
             scan_state_type(scan_initial_type i, Subscriber scrbr)
-                : scan_initial_type(i)
+                : scan_initial_type(std::move(i))
                 , result(scan_initial_type::seed)
                 , out(std::move(scrbr))
             {
@@ -64,13 +69,10 @@ struct scan : public operator_base<typename std::decay<Seed>::type>
             state->out,
         // on_next
             [state](T t) {
-                auto result = on_exception(
-                    [&](){return state->accumulator(state->result, t);},
-                    state->out);
-                if (result.empty()) {
+                if (!accumulate(state->result, state->accumulator, std::move(t), state->out, in_place())) {
                     return;
                 }
-                state->result = result.get();
+                // an observer that takes the value by reference does not copy it
                 state->out.on_next(state->result);
             },
         // on_error
@@ -96,7 +98,7 @@ class scan_factory
 public:
     scan_factory(accumulator_type a, Seed s)
         : accumulator(std::move(a))
-        , seed(s)
+        , seed(std::move(s))
     {
     }
     template<class Observable>
@@ -112,7 +114,7 @@ public:
 template<class Seed, class Accumulator>
 auto scan(Seed s, Accumulator&& a)
     ->      detail::scan_factory<Accumulator, Seed> {
-    return  detail::scan_factory<Accumulator, Seed>(std::forward<Accumulator>(a), s);
+    return  detail::scan_factory<Accumulator, Seed>(std::forward<Accumulator>(a), std::move(s));
 }
 
 }
@@ -0,0 +1,205 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved. See License.txt in the project root for license information.
+
+#pragma once
+
+#if !defined(RXCPP_OPERATORS_RX_THROTTLE_FIRST_HPP)
+#define RXCPP_OPERATORS_RX_THROTTLE_FIRST_HPP
+
+#include "../rx-includes.hpp"
+
+namespace rxcpp {
+
+namespace operators {
+
+namespace detail {
+
+// the values are dropped by comparing against the worker's clock on the
+// source thread. the values that pass are delivered on the coordination's
+// worker by one schedulable that is scheduled again for each batch.
+template<class T, class Coordination>
+struct throttle_first
+{
+    typedef typename std::decay<T>::type source_value_type;
+    typedef typename std::decay<Coordination>::type coordination_type;
+    typedef typename coordination_type::coordinator_type coordinator_type;
+    typedef rxsc::scheduler::clock_type clock_type;
+
+    struct throttle_first_values
+    {
+        throttle_first_values(clock_type::duration p, coordination_type cn)
+            : period(p)
+            , coordination(std::move(cn))
+        {
+        }
+        clock_type::duration period;
+        coordination_type coordination;
+    };
+
+    throttle_first_values initial;
+
+    throttle_first(clock_type::duration period, coordination_type cn)
+        : initial(period, std::move(cn))
+    {
+        // a window that ends where it starts would not drop any values
+        if (period <= clock_type::duration::zero()) {
+            throw std::invalid_argument("throttle_first period must be greater than zero");
+        }
+    }
+
+    template<class Subscriber>
+    struct throttle_first_observer
+    {
+        typedef throttle_first_observer<Subscriber> this_type;
+        typedef typename std::decay<Subscriber>::type dest_type;
+        typedef observer<source_value_type, this_type> observer_type;
+
+        struct throttle_first_state
+            : public timed_state<throttle_first_values, coordination_type, dest_type>
+            , public std::enable_shared_from_this<throttle_first_state>
+        {
+            throttle_first_state(dest_type d, throttle_first_values v, coordinator_type coor, composite_subscription cs)
+                : timed_state<throttle_first_values, coordination_type, dest_type>(std::move(d), std::move(v), std::move(coor), std::move(cs))
+                , open(clock_type::time_point::min())
+                , draining(false)
+                , completed(false)
+            {
+            }
+
+            std::mutex lock;
+            // the next value is dropped until open
+            clock_type::time_point open;
+            // the values waiting to be delivered by the worker
+            std::vector<source_value_type> pending;
+            bool draining;
+            bool completed;
+            std::exception_ptr error;
+
+            // must only be used on the worker
+            std::vector<source_value_type> batch;
+
+            rxu::maybe<rxsc::schedulable> drainer;
+
+            // must only be called on the worker
+            void drain() {
+                bool done = false;
+                std::exception_ptr e;
+                {
+                    std::unique_lock<std::mutex> guard(lock);
+                    batch.swap(pending);
+                    draining = false;
+                    done = completed;
+                    e = error;
+                }
+                for (auto& v : batch) {
+                    this->dest.on_next(std::move(v));
+                }
+                batch.clear();
+                if (!done) {
+                    return;
+                }
+                if (e) {
+                    this->dest.on_error(e);
+                } else {
+                    this->dest.on_completed();
+                }
+                this->lifetime.unsubscribe();
+            }
+
+            void ensure_draining(std::unique_lock<std::mutex>& guard) {
+                if (draining || drainer.empty()) {
+                    return;
+                }
+                draining = true;
+                guard.unlock();
+                drainer->schedule();
+            }
+        };
+        std::shared_ptr<throttle_first_state> state;
+
+        explicit throttle_first_observer(std::shared_ptr<throttle_first_state> s)
+            : state(std::move(s))
+        {
+        }
+
+        void on_next(source_value_type v) const {
+            auto now = state->worker.now();
+            std::unique_lock<std::mutex> guard(state->lock);
+            if (state->completed || now < state->open) {
+                return;
+            }
+            state->open = now + state->values.period;
+            state->pending.push_back(std::move(v));
+            state->ensure_draining(guard);
+        }
+        void on_error(std::exception_ptr e) const {
+            std::unique_lock<std::mutex> guard(state->lock);
+            if (state->completed) {
+                return;
+            }
+            state->completed = true;
+            state->error = e;
+            state->ensure_draining(guard);
+        }
+        void on_completed() const {
+            std::unique_lock<std::mutex> guard(state->lock);
+            if (state->completed) {
+                return;
+            }
+            state->completed = true;
+            state->ensure_draining(guard);
+        }
+
+        static subscriber<source_value_type, observer_type> make(dest_type d, throttle_first_values v) {
+            auto state = make_timed_state<throttle_first_state>(d, std::move(v));
+
+            state->drainer = timed_action(state, [](throttle_first_state& s, const rxsc::schedulable&){
+                s.drain();
+            });
+
+            return make_subscriber<source_value_type>(d, state->lifetime, observer_type(this_type(state)));
+        }
+    };
+
+    template<class Subscriber>
+    auto operator()(Subscriber dest) const
+        -> decltype(throttle_first_observer<Subscriber>::make(std::move(dest), initial)) {
+        return      throttle_first_observer<Subscriber>::make(std::move(dest), initial);
+    }
+};
+
+template<class Coordination>
+class throttle_first_factory
+{
+    typedef typename std::decay<Coordination>::type coordination_type;
+    typedef rxsc::scheduler::clock_type clock_type;
+
+    clock_type::duration period;
+    coordination_type coordination;
+public:
+    throttle_first_factory(clock_type::duration p, coordination_type cn)
+        : period(p)
+        , coordination(std::move(cn))
+    {
+    }
+    template<class Observable>
+    auto operator()(Observable&& source)
+        -> decltype(source.template lift<typename std::decay<Observable>::type::value_type>(throttle_first<typename std::decay<Observable>::type::value_type, Coordination>(period, coordination))) {
+        return      source.template lift<typename std::decay<Observable>::type::value_type>(throttle_first<typename std::decay<Observable>::type::value_type, Coordination>(period, coordination));
+    }
+};
+
+}
+
+/// emits a value and then drops the values received in the following
+/// period, timed by the worker of cn
+template<class Coordination>
+inline auto throttle_first(rxsc::scheduler::clock_type::duration period, Coordination cn)
+    ->      detail::throttle_first_factory<Coordination> {
+    return  detail::throttle_first_factory<Coordination>(period, std::move(cn));
+}
+
+}
+
+}
+
+#endif
@@ -0,0 +1,220 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved. See License.txt in the project root for license information.
+
+#pragma once
+
+#if !defined(RXCPP_OPERATORS_RX_TIMEOUT_HPP)
+#define RXCPP_OPERATORS_RX_TIMEOUT_HPP
+
+#include "../rx-includes.hpp"
+
+namespace rxcpp {
+
+/// the error emitted by timeout when no value is received in time
+struct timeout_error : public std::runtime_error
+{
+    explicit timeout_error(const std::string& msg)
+        : std::runtime_error(msg)
+    {
+    }
+};
+
+namespace operators {
+
+namespace detail {
+
+// the values are passed through on the source thread and only record when
+// they arrived. one timer on the coordination's worker wakes when the
+// period after the last value ends and, when another value arrived since,
+// schedules itself again for the new end.
+template<class T, class Coordination>
+struct timeout
+{
+    typedef typename std::decay<T>::type source_value_type;
+    typedef typename std::decay<Coordination>::type coordination_type;
+    typedef typename coordination_type::coordinator_type coordinator_type;
+    typedef rxsc::scheduler::clock_type clock_type;
+
+    struct timeout_values
+    {
+        timeout_values(clock_type::duration p, coordination_type cn)
+            : period(p)
+            , coordination(std::move(cn))
+        {
+        }
+        clock_type::duration period;
+        coordination_type coordination;
+    };
+
+    timeout_values initial;
+
+    timeout(clock_type::duration period, coordination_type cn)
+        : initial(period, std::move(cn))
+    {
+        // the timeout would expire before the first value could arrive
+        if (period <= clock_type::duration::zero()) {
+            throw std::invalid_argument("timeout period must be greater than zero");
+        }
+    }
+
+    template<class Subscriber>
+    struct timeout_observer
+    {
+        typedef timeout_observer<Subscriber> this_type;
+        typedef typename std::decay<Subscriber>::type dest_type;
+        typedef observer<source_value_type, this_type> observer_type;
+
+        struct timeout_state
+            : public timed_state<timeout_values, coordination_type, dest_type>
+            , public std::enable_shared_from_this<timeout_state>
+        {
+            timeout_state(dest_type d, timeout_values v, coordinator_type coor, composite_subscription cs)
+                : timed_state<timeout_values, coordination_type, dest_type>(std::move(d), std::move(v), std::move(coor), std::move(cs))
+                , emitting(false)
+                , timed_out(false)
+                , completed(false)
+            {
+            }
+
+            // the values and the timeout are delivered outside of the lock.
+            // a timeout that expires while a value is being delivered is
+            // delivered by the source thread when the value returns.
+            std::mutex lock;
+            clock_type::time_point deadline;
+            bool emitting;
+            bool timed_out;
+            bool completed;
+
+            void expire() {
+                this->dest.on_error(std::make_exception_ptr(timeout_error("timeout has occurred")));
+                this->lifetime.unsubscribe();
+            }
+
+            // must only be called on the worker
+            void tick(const rxsc::schedulable& self) {
+                clock_type::time_point wake;
+                {
+                    std::unique_lock<std::mutex> guard(lock);
+                    if (completed) {
+                        return;
+                    }
+                    wake = deadline;
+                    if (this->worker.now() >= wake) {
+                        completed = true;
+                        if (emitting) {
+                            timed_out = true;
+                            return;
+                        }
+                        guard.unlock();
+                        expire();
+                        return;
+                    }
+                }
+                self.schedule(wake);
+            }
+        };
+        std::shared_ptr<timeout_state> state;
+
+        explicit timeout_observer(std::shared_ptr<timeout_state> s)
+            : state(std::move(s))
+        {
+        }
+
+        void on_next(source_value_type v) const {
+            auto deadline = state->worker.now() + state->values.period;
+            {
+                std::unique_lock<std::mutex> guard(state->lock);
+                if (state->completed) {
+                    return;
+                }
+                state->deadline = deadline;
+                state->emitting = true;
+            }
+            state->dest.on_next(std::move(v));
+            {
+                std::unique_lock<std::mutex> guard(state->lock);
+                state->emitting = false;
+                if (!state->timed_out) {
+                    return;
+                }
+            }
+            state->expire();
+        }
+        void on_error(std::exception_ptr e) const {
+            {
+                std::unique_lock<std::mutex> guard(state->lock);
+                if (state->completed) {
+                    return;
+                }
+                state->completed = true;
+            }
+            state->dest.on_error(e);
+        }
+        void on_completed() const {
+            {
+                std::unique_lock<std::mutex> guard(state->lock);
+                if (state->completed) {
+                    return;
+                }
+                state->completed = true;
+            }
+            state->dest.on_completed();
+        }
+
+        static subscriber<source_value_type, observer_type> make(dest_type d, timeout_values v) {
+            auto state = make_timed_state<timeout_state>(d, std::move(v));
+
+            auto timer = timed_action(state, [](timeout_state& s, const rxsc::schedulable& self){
+                s.tick(self);
+            });
+            if (!timer.empty()) {
+                state->deadline = state->worker.now() + state->values.period;
+                timer->schedule(state->deadline);
+            }
+
+            return make_subscriber<source_value_type>(d, state->lifetime, observer_type(this_type(state)));
+        }
+    };
+
+    template<class Subscriber>
+    auto operator()(Subscriber dest) const
+        -> decltype(timeout_observer<Subscriber>::make(std::move(dest), initial)) {
+        return      timeout_observer<Subscriber>::make(std::move(dest), initial);
+    }
+};
+
+template<class Coordination>
+class timeout_factory
+{
+    typedef typename std::decay<Coordination>::type coordination_type;
+    typedef rxsc::scheduler::clock_type clock_type;
+
+    clock_type::duration period;
+    coordination_type coordination;
+public:
+    timeout_factory(clock_type::duration p, coordination_type cn)
+        : period(p)
+        , coordination(std::move(cn))
+    {
+    }
+    template<class Observable>
+    auto operator()(Observable&& source)
+        -> decltype(source.template lift<typename std::decay<Observable>::type::value_type>(timeout<typename std::decay<Observable>::type::value_type, Coordination>(period, coordination))) {
+        return      source.template lift<typename std::decay<Observable>::type::value_type>(timeout<typename std::decay<Observable>::type::value_type, Coordination>(period, coordination));
+    }
+};
+
+}
+
+/// emits a timeout_error when no value is received for period after the
+/// subscription or the last value, timed on the worker of cn
+template<class Coordination>
+inline auto timeout(rxsc::scheduler::clock_type::duration period, Coordination cn)
+    ->      detail::timeout_factory<Coordination> {
+    return  detail::timeout_factory<Coordination>(period, std::move(cn));
+}
+
+}
+
+}
+
+#endif
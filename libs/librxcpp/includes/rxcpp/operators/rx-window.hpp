@@ -56,7 +56,7 @@ struct window
             dest.on_next(subj[0].get_observable().as_dynamic());
         }
         void on_next(T v) const {
-            for (auto s : subj) {
+            for (auto& s : subj) {
                 s.get_subscriber().on_next(v);
             }
 
@@ -73,14 +73,14 @@ struct window
         }
 
         void on_error(std::exception_ptr e) const {
-            for (auto s : subj) {
+            for (auto& s : subj) {
                 s.get_subscriber().on_error(e);
             }
             dest.on_error(e);
         }
 
         void on_completed() const {
-            for (auto s : subj) {
+            for (auto& s : subj) {
                 s.get_subscriber().on_completed();
             }
             dest.on_completed();
@@ -0,0 +1,281 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved. See License.txt in the project root for license information.
+
+#pragma once
+
+#if !defined(RXCPP_OPERATORS_RX_WINDOW_TIME_HPP)
+#define RXCPP_OPERATORS_RX_WINDOW_TIME_HPP
+
+#include "../rx-includes.hpp"
+
+namespace rxcpp {
+
+namespace operators {
+
+namespace detail {
+
+// windows are opened and closed by timers on the coordination's worker.
+// the values are queued and delivered in batches on the worker, each value
+// is passed by reference to every open window. only the subscribers of a
+// window that take values by value copy them.
+template<class T, class Coordination>
+struct window_with_time
+{
+    typedef typename std::decay<T>::type source_value_type;
+    typedef observable<source_value_type> value_type;
+    typedef typename std::decay<Coordination>::type coordination_type;
+    typedef typename coordination_type::coordinator_type coordinator_type;
+    typedef rxsc::scheduler::clock_type clock_type;
+
+    struct window_with_time_values
+    {
+        window_with_time_values(clock_type::duration p, clock_type::duration s, coordination_type cn)
+            : period(p)
+            , skip(s)
+            , coordination(std::move(cn))
+        {
+        }
+        clock_type::duration period;
+        clock_type::duration skip;
+        coordination_type coordination;
+    };
+
+    window_with_time_values initial;
+
+    window_with_time(clock_type::duration period, clock_type::duration skip, coordination_type cn)
+        : initial(period, skip, std::move(cn))
+    {
+        // the timers would open windows forever without time passing
+        if (period <= clock_type::duration::zero() || skip <= clock_type::duration::zero()) {
+            throw std::invalid_argument("window_with_time period and skip must be greater than zero");
+        }
+    }
+
+    template<class Subscriber>
+    struct window_with_time_observer
+    {
+        typedef window_with_time_observer<Subscriber> this_type;
+        typedef typename std::decay<Subscriber>::type dest_type;
+        typedef observer<source_value_type, this_type> observer_type;
+        typedef rxsub::subject<source_value_type> subject_type;
+
+        struct open_window
+        {
+            open_window(subject_type s, clock_type::time_point d)
+                : subscriber(s.get_subscriber())
+                , deadline(d)
+            {
+            }
+            typename subject_type::subscriber_type subscriber;
+            clock_type::time_point deadline;
+        };
+
+        struct window_with_time_state
+            : public timed_state<window_with_time_values, coordination_type, dest_type>
+            , public std::enable_shared_from_this<window_with_time_state>
+        {
+            window_with_time_state(dest_type d, window_with_time_values v, coordinator_type coor, composite_subscription cs)
+                : timed_state<window_with_time_values, coordination_type, dest_type>(std::move(d), std::move(v), std::move(coor), std::move(cs))
+                , draining(false)
+                , completed(false)
+            {
+            }
+
+            std::mutex lock;
+            // the values waiting to be delivered by the worker
+            std::vector<source_value_type> pending;
+            bool draining;
+            bool completed;
+            std::exception_ptr error;
+
+            // must only be used on the worker
+            std::deque<open_window> open;
+            clock_type::time_point next_open;
+            std::vector<source_value_type> batch;
+
+            void open_one(clock_type::time_point deadline) {
+                subject_type s;
+                open.push_back(open_window(s, deadline));
+                this->dest.on_next(s.get_observable());
+            }
+
+            // opens and closes the windows that are due by now and returns
+            // when the next one is due.
+            clock_type::time_point advance(clock_type::time_point now) {
+                for (;;) {
+                    bool closing = !open.empty() && open.front().deadline <= now;
+                    bool opening = next_open <= now;
+                    if (closing && (!opening || open.front().deadline <= next_open)) {
+                        auto s = std::move(open.front().subscriber);
+                        open.pop_front();
+                        s.on_completed();
+                    } else if (opening) {
+                        open_one(next_open + this->values.period);
+                        next_open += this->values.skip;
+                    } else {
+                        break;
+                    }
+                }
+                auto wake = next_open;
+                if (!open.empty()) {
+                    wake = std::min(wake, open.front().deadline);
+                }
+                return wake;
+            }
+
+            void tick(const rxsc::schedulable& self) {
+                drain();
+                if (!this->lifetime.is_subscribed()) {
+                    return;
+                }
+                self.schedule(advance(this->worker.now()));
+            }
+
+            // must only be called on the worker
+            void drain() {
+                bool done = false;
+                std::exception_ptr e;
+                {
+                    std::unique_lock<std::mutex> guard(lock);
+                    batch.swap(pending);
+                    draining = false;
+                    done = completed;
+                    e = error;
+                }
+                for (auto& v : batch) {
+                    for (auto& w : open) {
+                        w.subscriber.on_next(v);
+                    }
+                }
+                batch.clear();
+                if (!done) {
+                    return;
+                }
+                for (auto& w : open) {
+                    if (e) {
+                        w.subscriber.on_error(e);
+                    } else {
+                        w.subscriber.on_completed();
+                    }
+                }
+                open.clear();
+                if (e) {
+                    this->dest.on_error(e);
+                } else {
+                    this->dest.on_completed();
+                }
+                this->lifetime.unsubscribe();
+            }
+
+            void ensure_draining(std::unique_lock<std::mutex>& guard) {
+                if (draining) {
+                    return;
+                }
+                draining = true;
+                guard.unlock();
+
+                auto keepAlive = this->shared_from_this();
+                this->schedule([keepAlive](const rxsc::schedulable&){
+                    keepAlive->drain();
+                });
+            }
+        };
+        std::shared_ptr<window_with_time_state> state;
+
+        explicit window_with_time_observer(std::shared_ptr<window_with_time_state> s)
+            : state(std::move(s))
+        {
+        }
+
+        void on_next(source_value_type v) const {
+            std::unique_lock<std::mutex> guard(state->lock);
+            if (state->completed) {
+                return;
+            }
+            state->pending.push_back(std::move(v));
+            state->ensure_draining(guard);
+        }
+        void on_error(std::exception_ptr e) const {
+            std::unique_lock<std::mutex> guard(state->lock);
+            if (state->completed) {
+                return;
+            }
+            state->completed = true;
+            state->error = e;
+            state->ensure_draining(guard);
+        }
+        void on_completed() const {
+            std::unique_lock<std::mutex> guard(state->lock);
+            if (state->completed) {
+                return;
+            }
+            state->completed = true;
+            state->ensure_draining(guard);
+        }
+
+        static subscriber<source_value_type, observer_type> make(dest_type d, window_with_time_values v) {
+            auto state = make_timed_state<window_with_time_state>(d, std::move(v));
+
+            // the first window opens on the worker before any value is delivered
+            state->next_open = state->worker.now();
+            auto tick = timed_action(state, [](window_with_time_state& s, const rxsc::schedulable& self){
+                s.tick(self);
+            });
+            if (!tick.empty()) {
+                tick->schedule();
+            }
+
+            return make_subscriber<source_value_type>(d, state->lifetime, observer_type(this_type(state)));
+        }
+    };
+
+    template<class Subscriber>
+    auto operator()(Subscriber dest) const
+        -> decltype(window_with_time_observer<Subscriber>::make(std::move(dest), initial)) {
+        return      window_with_time_observer<Subscriber>::make(std::move(dest), initial);
+    }
+};
+
+template<class Coordination>
+class window_with_time_factory
+{
+    typedef typename std::decay<Coordination>::type coordination_type;
+    typedef rxsc::scheduler::clock_type clock_type;
+
+    clock_type::duration period;
+    clock_type::duration skip;
+    coordination_type coordination;
+public:
+    window_with_time_factory(clock_type::duration p, clock_type::duration s, coordination_type cn)
+        : period(p)
+        , skip(s)
+        , coordination(std::move(cn))
+    {
+    }
+    template<class Observable>
+    auto operator()(Observable&& source)
+        -> decltype(source.template lift<observable<typename std::decay<Observable>::type::value_type>>(window_with_time<typename std::decay<Observable>::type::value_type, Coordination>(period, skip, coordination))) {
+        return      source.template lift<observable<typename std::decay<Observable>::type::value_type>>(window_with_time<typename std::decay<Observable>::type::value_type, Coordination>(period, skip, coordination));
+    }
+};
+
+}
+
+/// emits a window of the values received in each period, timed on the worker of cn
+template<class Coordination>
+inline auto window_with_time(rxsc::scheduler::clock_type::duration period, Coordination cn)
+    ->      detail::window_with_time_factory<Coordination> {
+    return  detail::window_with_time_factory<Coordination>(period, period, std::move(cn));
+}
+/// emits a window of the values received in a period that starts every skip.
+/// the windows overlap when skip is shorter than period.
+template<class Coordination>
+inline auto window_with_time(rxsc::scheduler::clock_type::duration period, rxsc::scheduler::clock_type::duration skip, Coordination cn)
+    ->      detail::window_with_time_factory<Coordination> {
+    return  detail::window_with_time_factory<Coordination>(period, skip, std::move(cn));
+}
+
+}
+
+}
+
+#endif
@@ -292,11 +292,26 @@ inline serialize_one_worker serialize_event_loop() {
     return r;
 }
 
+inline serialize_one_worker serialize_elastic_event_loop() {
+    static serialize_one_worker r(rxsc::make_elastic_event_loop());
+    return r;
+}
+
 inline serialize_one_worker serialize_new_thread() {
     static serialize_one_worker r(rxsc::make_new_thread());
     return r;
 }
 
+inline serialize_one_worker serialize_pooled_thread() {
+    static serialize_one_worker r(rxsc::make_pooled_thread());
+    return r;
+}
+
+inline serialize_one_worker serialize_work_stealing() {
+    static serialize_one_worker r(rxsc::make_work_stealing());
+    return r;
+}
+
 
 }
 
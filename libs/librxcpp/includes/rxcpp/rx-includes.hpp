@@ -23,6 +23,10 @@
 #define RXCPP_USE_RTTI 1
 #endif
 
+#if _MSC_VER >= 1900
+#define RXCPP_USE_THREAD_LOCAL 1
+#endif
+
 #elif defined(__clang__)
 
 #if __has_feature(cxx_rvalue_references)
@@ -34,6 +38,9 @@
 #if __has_feature(cxx_variadic_templates)
 #define RXCPP_USE_VARIADIC_TEMPLATES 1
 #endif
+#if __has_feature(cxx_thread_local)
+#define RXCPP_USE_THREAD_LOCAL 1
+#endif
 
 #elif defined(__GNUG__)
 
@@ -53,6 +60,10 @@
 #define RXCPP_USE_RTTI 1
 #endif
 
+#if GCC_VERSION >= 40800
+#define RXCPP_USE_THREAD_LOCAL 1
+#endif
+
 #endif
 
 #if !defined(WINAPI_FAMILY) || (WINAPI_FAMILY == WINAPI_FAMILY_DESKTOP_APP)
@@ -76,6 +87,11 @@
 #define RXCPP_USE_RTTI RXCPP_FORCE_USE_RTTI
 #endif
 
+#if defined(RXCPP_FORCE_USE_THREAD_LOCAL)
+#undef RXCPP_USE_THREAD_LOCAL
+#define RXCPP_USE_THREAD_LOCAL RXCPP_FORCE_USE_THREAD_LOCAL
+#endif
+
 #if defined(RXCPP_FORCE_USE_WINRT)
 #undef RXCPP_USE_WINRT
 #define RXCPP_USE_WINRT RXCPP_FORCE_USE_WINRT
@@ -99,6 +115,7 @@
 #include <iomanip>
 
 #include <exception>
+#include <stdexcept>
 #include <functional>
 #include <memory>
 #include <array>
@@ -119,6 +136,10 @@
 #include <initializer_list>
 #include <typeinfo>
 
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#include <intrin.h>
+#endif
+
 #include "rx-util.hpp"
 #include "rx-predef.hpp"
 #include "rx-subscription.hpp"
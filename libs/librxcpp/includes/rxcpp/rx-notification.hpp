@@ -236,6 +236,78 @@ template<class T>
 //static
 RXCPP_SELECT_ANY const typename notification<T>::on_error_factory notification<T>::on_error = notification<T>::on_error_factory();
 
+/// inline_notification holds a notification by value. it is used
+/// where notifications are queued and delivered exactly once, so that a
+/// queue of them can be reused without an allocation per notification.
+template<class T>
+class inline_notification
+{
+public:
+    struct kind
+    {
+        enum type {
+            Invalid = 0,
+            OnNext,
+            OnError,
+            OnCompleted
+        };
+    };
+
+private:
+    typename kind::type k;
+    rxu::maybe<T> value;
+    std::exception_ptr ep;
+
+    explicit inline_notification(typename kind::type k)
+        : k(k)
+    {
+    }
+
+public:
+    inline_notification()
+        : k(kind::Invalid)
+    {
+    }
+
+    static inline_notification on_next(T v) {
+        inline_notification result(kind::OnNext);
+        result.value.reset(std::move(v));
+        return result;
+    }
+    static inline_notification on_error(std::exception_ptr e) {
+        inline_notification result(kind::OnError);
+        result.ep = std::move(e);
+        return result;
+    }
+    static inline_notification on_completed() {
+        return inline_notification(kind::OnCompleted);
+    }
+
+    typename kind::type get_kind() const {
+        return k;
+    }
+
+    /// deliver the notification to the observer.
+    /// the value is moved out, so this can only be called once.
+    template<class Observer>
+    void accept(const Observer& o) {
+        switch (k) {
+        case kind::OnNext:
+            o.on_next(std::move(value.get()));
+            value.reset();
+            break;
+        case kind::OnError:
+            o.on_error(ep);
+            break;
+        case kind::OnCompleted:
+            o.on_completed();
+            break;
+        default:
+            abort();
+        }
+    }
+};
+
 template<class T>
 bool operator == (const std::shared_ptr<detail::notification_base<T>>& lhs, const std::shared_ptr<detail::notification_base<T>>& rhs) {
     if (!lhs && !rhs) {return true;}
@@ -52,30 +52,67 @@ template<class T>
 class dynamic_observable
     : public rxs::source_base<T>
 {
-    struct state_type
-        : public std::enable_shared_from_this<state_type>
+    // one table of functions for each type of source.
+    // the source is held inline when it is small enough. a copy of a small
+    // source is a copy, a large source is shared by the copies, see
+    // inline_erased. sources keep their shared state in a shared_ptr, so
+    // both behave the same.
+    struct vtable
     {
-        typedef std::function<void(subscriber<T>)> onsubscribe_type;
+        void (*on_subscribe)(void*, subscriber<T>);
+    };
 
-        onsubscribe_type on_subscribe;
+    template<class SO>
+    struct specific_source
+    {
+        static void on_subscribe(void* so, subscriber<T> o) {
+            static_cast<SO*>(so)->on_subscribe(std::move(o));
+        }
+        static const vtable* table() {
+            static const vtable t = {&on_subscribe};
+            return &t;
+        }
+    };
+
+    template<class F>
+    struct specific_function
+    {
+        static void on_subscribe(void* f, subscriber<T> o) {
+            (*static_cast<F*>(f))(std::move(o));
+        }
+        static const vtable* table() {
+            static const vtable t = {&on_subscribe};
+            return &t;
+        }
     };
-    std::shared_ptr<state_type> state;
+
+    rxu::detail::inline_erased<> source;
+    const vtable* table;
+    // copies share the id of the observable they were copied from.
+    // zero when empty.
+    size_t id;
+
+    static size_t next_id() {
+        static std::atomic<size_t> last(0);
+        return ++last;
+    }
 
     template<class U>
     friend bool operator==(const dynamic_observable<U>&, const dynamic_observable<U>&);
 
     template<class SO>
-    void construct(SO&& source, rxs::tag_source&&) {
-        typename std::decay<SO>::type so = std::forward<SO>(source);
-        state->on_subscribe = [so](subscriber<T> o) mutable {
-            so.on_subscribe(std::move(o));
-        };
+    void construct(SO&& so, rxs::tag_source&&) {
+        typedef typename std::decay<SO>::type source_type;
+        source.template emplace<source_type>(std::forward<SO>(so));
+        table = specific_source<source_type>::table();
     }
 
     struct tag_function {};
     template<class F>
     void construct(F&& f, tag_function&&) {
-        state->on_subscribe = std::forward<F>(f);
+        typedef typename std::decay<F>::type function_type;
+        source.template emplace<function_type>(std::forward<F>(f));
+        table = specific_function<function_type>::table();
     }
 
 public:
@@ -83,31 +120,35 @@ public:
     typedef tag_dynamic_observable dynamic_observable_tag;
 
     dynamic_observable()
+        : table(nullptr)
+        , id(0)
     {
     }
 
     template<class SOF>
     explicit dynamic_observable(SOF&& sof, typename std::enable_if<!is_dynamic_observable<SOF>::value, void**>::type = 0)
-        : state(std::make_shared<state_type>())
+        : table(nullptr)
+        , id(next_id())
     {
         construct(std::forward<SOF>(sof),
                   typename std::conditional<rxs::is_source<SOF>::value || rxo::is_operator<SOF>::value, rxs::tag_source, tag_function>::type());
     }
 
     void on_subscribe(subscriber<T> o) const {
-        state->on_subscribe(std::move(o));
+        table->on_subscribe(source.get(), std::move(o));
     }
 
     template<class Subscriber>
     typename std::enable_if<is_subscriber<Subscriber>::value, void>::type
     on_subscribe(Subscriber o) const {
-        state->on_subscribe(o.as_dynamic());
+        table->on_subscribe(source.get(), o.as_dynamic());
     }
 };
 
+/// dynamic observables are equal when one is a copy of the other.
 template<class T>
 inline bool operator==(const dynamic_observable<T>& lhs, const dynamic_observable<T>& rhs) {
-    return lhs.state == rhs.state;
+    return lhs.table == rhs.table && lhs.id == rhs.id;
 }
 template<class T>
 inline bool operator!=(const dynamic_observable<T>& lhs, const dynamic_observable<T>& rhs) {
@@ -498,6 +539,25 @@ public:
         return                    lift<observable<T>>(rxo::detail::window<T>(count, skip));
     }
 
+    /// window_with_time ->
+    /// emits a window of the values received in each period, timed on the worker of cn.
+    ///
+    template<class Coordination>
+    auto window_with_time(rxsc::scheduler::clock_type::duration period, Coordination cn) const
+        -> decltype(EXPLICIT_THIS lift<observable<T>>(rxo::detail::window_with_time<T, Coordination>(period, period, std::move(cn)))) {
+        return                    lift<observable<T>>(rxo::detail::window_with_time<T, Coordination>(period, period, std::move(cn)));
+    }
+
+    /// window_with_time ->
+    /// emits a window of the values received in a period that starts every skip, timed on the worker of cn.
+    /// throws std::invalid_argument unless period and skip are greater than zero.
+    ///
+    template<class Coordination>
+    auto window_with_time(rxsc::scheduler::clock_type::duration period, rxsc::scheduler::clock_type::duration skip, Coordination cn) const
+        -> decltype(EXPLICIT_THIS lift<observable<T>>(rxo::detail::window_with_time<T, Coordination>(period, skip, std::move(cn)))) {
+        return                    lift<observable<T>>(rxo::detail::window_with_time<T, Coordination>(period, skip, std::move(cn)));
+    }
+
     /// buffer ->
     /// collect count items from this observable and produce a vector of them to emit from the new observable that is returned.
     ///
@@ -514,6 +574,35 @@ public:
         return                    lift<std::vector<T>>(rxo::detail::buffer_count<T>(count, skip));
     }
 
+    /// buffer_with_time ->
+    /// emits the values received in each period, timed on the worker of cn.
+    ///
+    template<class Coordination>
+    auto buffer_with_time(rxsc::scheduler::clock_type::duration period, Coordination cn) const
+        -> decltype(EXPLICIT_THIS lift<std::vector<T>>(rxo::detail::buffer_with_time<T, Coordination>(period, period, 0, std::move(cn)))) {
+        return                    lift<std::vector<T>>(rxo::detail::buffer_with_time<T, Coordination>(period, period, 0, std::move(cn)));
+    }
+
+    /// buffer_with_time ->
+    /// emits the values received in a period that starts every skip, timed on the worker of cn.
+    /// overlapping buffers share one store of the values.
+    /// throws std::invalid_argument unless period and skip are greater than zero.
+    ///
+    template<class Coordination>
+    auto buffer_with_time(rxsc::scheduler::clock_type::duration period, rxsc::scheduler::clock_type::duration skip, Coordination cn) const
+        -> decltype(EXPLICIT_THIS lift<std::vector<T>>(rxo::detail::buffer_with_time<T, Coordination>(period, skip, 0, std::move(cn)))) {
+        return                    lift<std::vector<T>>(rxo::detail::buffer_with_time<T, Coordination>(period, skip, 0, std::move(cn)));
+    }
+
+    /// buffer_with_time_or_count ->
+    /// emits a buffer when it holds count values or when period has passed, whichever is first.
+    ///
+    template<class Coordination>
+    auto buffer_with_time_or_count(rxsc::scheduler::clock_type::duration period, size_t count, Coordination cn) const
+        -> decltype(EXPLICIT_THIS lift<std::vector<T>>(rxo::detail::buffer_with_time<T, Coordination>(period, period, std::max<size_t>(count, 1), std::move(cn)))) {
+        return                    lift<std::vector<T>>(rxo::detail::buffer_with_time<T, Coordination>(period, period, std::max<size_t>(count, 1), std::move(cn)));
+    }
+
     template<class Coordination>
     struct defer_switch_on_next : public defer_observable<
         is_observable<value_type>,
@@ -797,6 +886,30 @@ public:
         return                    lift<typename rxo::detail::group_by_traits<T, this_type, KeySelector, MarbleSelector, rxu::less>::grouped_observable_type>(rxo::detail::group_by<T, this_type, KeySelector, MarbleSelector, rxu::less>(std::move(ks), std::move(ms), rxu::less()));
     }
 
+    /// group_by_hashed ->
+    /// group_by with the groups in a hash table. groups are removed when every
+    /// subscriber to them has unsubscribed and as selected by the eviction.
+    /// groups are only checked when the source emits, so idle and released
+    /// groups stay open while the source is quiet. the counters report the
+    /// number of groups.
+    ///
+    template<class KeySelector, class MarbleSelector>
+    inline auto group_by_hashed(KeySelector ks, MarbleSelector ms, group_by_eviction e = group_by_eviction(), group_by_counters c = group_by_counters()) const
+        -> decltype(EXPLICIT_THIS lift<typename rxo::detail::group_by_hashed<T, this_type, KeySelector, MarbleSelector, identity_one_worker>::grouped_observable_type>(rxo::detail::group_by_hashed<T, this_type, KeySelector, MarbleSelector, identity_one_worker>(std::move(ks), std::move(ms), e, std::move(c), identity_immediate(), false))) {
+        return                    lift<typename rxo::detail::group_by_hashed<T, this_type, KeySelector, MarbleSelector, identity_one_worker>::grouped_observable_type>(rxo::detail::group_by_hashed<T, this_type, KeySelector, MarbleSelector, identity_one_worker>(std::move(ks), std::move(ms), e, std::move(c), identity_immediate(), false));
+    }
+
+    /// group_by_hashed ->
+    /// as above, and a timer on the worker of cn removes the idle and
+    /// released groups on time, also while the source is quiet.
+    ///
+    template<class KeySelector, class MarbleSelector, class Coordination>
+    inline auto group_by_hashed(KeySelector ks, MarbleSelector ms, group_by_eviction e, Coordination cn, group_by_counters c = group_by_counters()) const
+        -> typename std::enable_if<is_coordination<Coordination>::value,
+            decltype(EXPLICIT_THIS lift<typename rxo::detail::group_by_hashed<T, this_type, KeySelector, MarbleSelector, Coordination>::grouped_observable_type>(rxo::detail::group_by_hashed<T, this_type, KeySelector, MarbleSelector, Coordination>(std::move(ks), std::move(ms), e, std::move(c), std::move(cn), true)))>::type {
+        return                    lift<typename rxo::detail::group_by_hashed<T, this_type, KeySelector, MarbleSelector, Coordination>::grouped_observable_type>(rxo::detail::group_by_hashed<T, this_type, KeySelector, MarbleSelector, Coordination>(std::move(ks), std::move(ms), e, std::move(c), std::move(cn), true));
+    }
+
     /// multicast ->
     /// allows connections to the source to be independent of subscriptions
     ///
@@ -854,14 +967,78 @@ public:
         return                    lift<T>(rxo::detail::observe_on<T, Coordination>(std::move(cn)));
     }
 
+    /// observe_on ->
+    /// all values are queued in a fixed size ring and delivered using the scheduler from the supplied coordination.
+    /// when the ring is full the overflow policy either blocks the producer or selects the values to drop.
+    /// the counters report the queue depth and the number of dropped values.
+    ///
+    template<class Coordination>
+    auto observe_on(Coordination cn, size_t capacity, overflow::type policy, observe_on_counters counters = observe_on_counters()) const
+        -> decltype(EXPLICIT_THIS lift<T>(rxo::detail::observe_on_bounded<T, Coordination>(std::move(cn), capacity, policy, std::move(counters)))) {
+        return                    lift<T>(rxo::detail::observe_on_bounded<T, Coordination>(std::move(cn), capacity, policy, std::move(counters)));
+    }
+
+    /// sample ->
+    /// emits the most recent value at the end of each period in which a value was received, timed on the worker of cn.
+    /// the value received before completion is emitted with the completion.
+    /// throws std::invalid_argument unless period is greater than zero.
+    ///
+    template<class Coordination>
+    auto sample(rxsc::scheduler::clock_type::duration period, Coordination cn) const
+        -> decltype(EXPLICIT_THIS lift<T>(rxo::detail::sample<T, Coordination>(period, std::move(cn)))) {
+        return                    lift<T>(rxo::detail::sample<T, Coordination>(period, std::move(cn)));
+    }
+
+    /// throttle_first ->
+    /// emits a value and then drops the values received in the following period, timed by the worker of cn.
+    /// throws std::invalid_argument unless period is greater than zero.
+    ///
+    template<class Coordination>
+    auto throttle_first(rxsc::scheduler::clock_type::duration period, Coordination cn) const
+        -> decltype(EXPLICIT_THIS lift<T>(rxo::detail::throttle_first<T, Coordination>(period, std::move(cn)))) {
+        return                    lift<T>(rxo::detail::throttle_first<T, Coordination>(period, std::move(cn)));
+    }
+
+    /// debounce ->
+    /// emits a value when no other value is received for period after it, timed on the worker of cn.
+    /// throws std::invalid_argument unless period is greater than zero.
+    ///
+    template<class Coordination>
+    auto debounce(rxsc::scheduler::clock_type::duration period, Coordination cn) const
+        -> decltype(EXPLICIT_THIS lift<T>(rxo::detail::debounce<T, Coordination>(period, std::move(cn)))) {
+        return                    lift<T>(rxo::detail::debounce<T, Coordination>(period, std::move(cn)));
+    }
+
+    /// delay ->
+    /// emits each value and the completion period after it is received, timed on the worker of cn.
+    /// an error is emitted without a delay.
+    /// throws std::invalid_argument unless period is greater than zero.
+    ///
+    template<class Coordination>
+    auto delay(rxsc::scheduler::clock_type::duration period, Coordination cn) const
+        -> decltype(EXPLICIT_THIS lift<T>(rxo::detail::delay<T, Coordination>(period, std::move(cn)))) {
+        return                    lift<T>(rxo::detail::delay<T, Coordination>(period, std::move(cn)));
+    }
+
+    /// timeout ->
+    /// emits a timeout_error when no value is received for period after the subscription or the last value, timed on the worker of cn.
+    /// throws std::invalid_argument unless period is greater than zero.
+    ///
+    template<class Coordination>
+    auto timeout(rxsc::scheduler::clock_type::duration period, Coordination cn) const
+        -> decltype(EXPLICIT_THIS lift<T>(rxo::detail::timeout<T, Coordination>(period, std::move(cn)))) {
+        return                    lift<T>(rxo::detail::timeout<T, Coordination>(period, std::move(cn)));
+    }
+
     /// reduce ->
     /// for each item from this observable use Accumulator to combine items, when completed use ResultSelector to produce a value that will be emitted from the new observable that is returned.
+    /// Accumulator is either Seed(Seed, T), which has the seed moved through it, or void(Seed&, T), which updates the seed in place.
     ///
     template<class Seed, class Accumulator, class ResultSelector>
     auto reduce(Seed seed, Accumulator&& a, ResultSelector&& rs) const
         ->      observable<typename rxo::detail::reduce<T, source_operator_type, Accumulator, ResultSelector, Seed>::value_type,    rxo::detail::reduce<T, source_operator_type, Accumulator, ResultSelector, Seed>> {
         return  observable<typename rxo::detail::reduce<T, source_operator_type, Accumulator, ResultSelector, Seed>::value_type,    rxo::detail::reduce<T, source_operator_type, Accumulator, ResultSelector, Seed>>(
-                                                                                                                                    rxo::detail::reduce<T, source_operator_type, Accumulator, ResultSelector, Seed>(source_operator, std::forward<Accumulator>(a), std::forward<ResultSelector>(rs), seed));
+                                                                                                                                    rxo::detail::reduce<T, source_operator_type, Accumulator, ResultSelector, Seed>(source_operator, std::forward<Accumulator>(a), std::forward<ResultSelector>(rs), std::move(seed)));
     }
 
     template<class Seed, class Accumulator, class ResultSelector>
@@ -910,12 +1087,13 @@ public:
 
     /// scan ->
     /// for each item from this observable use Accumulator to combine items into a value that will be emitted from the new observable that is returned.
+    /// Accumulator is either Seed(Seed, T), which has the seed moved through it, or void(Seed&, T), which updates the seed in place.
     ///
     template<class Seed, class Accumulator>
     auto scan(Seed seed, Accumulator&& a) const
         ->      observable<Seed,    rxo::detail::scan<T, this_type, Accumulator, Seed>> {
         return  observable<Seed,    rxo::detail::scan<T, this_type, Accumulator, Seed>>(
-                                    rxo::detail::scan<T, this_type, Accumulator, Seed>(*this, std::forward<Accumulator>(a), seed));
+                                    rxo::detail::scan<T, this_type, Accumulator, Seed>(*this, std::forward<Accumulator>(a), std::move(seed)));
     }
 
     /// skip ->
@@ -1122,6 +1300,11 @@ public:
         return      rxs::range<T>(first, last, step, std::move(cn));
     }
     template<class T, class Coordination>
+    static auto range(T first, T last, ptrdiff_t step, Coordination cn, std::size_t batch)
+        -> decltype(rxs::range<T>(first, last, step, std::move(cn), batch)) {
+        return      rxs::range<T>(first, last, step, std::move(cn), batch);
+    }
+    template<class T, class Coordination>
     static auto range(T first, T last, Coordination cn)
         -> decltype(rxs::range<T>(first, last, std::move(cn))) {
         return      rxs::range<T>(first, last, std::move(cn));
@@ -1169,6 +1352,11 @@ public:
         -> decltype(rxs::iterate(std::move(c), std::move(cn))) {
         return      rxs::iterate(std::move(c), std::move(cn));
     }
+    template<class Collection, class Coordination>
+    static auto iterate(Collection c, Coordination cn, std::size_t batch)
+        -> decltype(rxs::iterate(std::move(c), std::move(cn), batch)) {
+        return      rxs::iterate(std::move(c), std::move(cn), batch);
+    }
     template<class T>
     static auto from()
         -> decltype(    rxs::from<T>()) {
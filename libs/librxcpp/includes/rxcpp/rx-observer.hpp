@@ -118,10 +118,11 @@ public:
         return *this;
     }
 
-    // use V so that std::move can be used safely
+    // an lvalue is passed through so that an on_next that takes a
+    // reference does not copy the value
     template<class V>
-    void on_next(V v) const {
-        onnext(std::move(v));
+    void on_next(V&& v) const {
+        onnext(std::forward<V>(v));
     }
     void on_error(std::exception_ptr e) const {
         onerror(e);
@@ -141,80 +142,90 @@ private:
     typedef dynamic_observer<T> this_type;
     typedef observer_base<T> base_type;
 
-    struct virtual_observer : public std::enable_shared_from_this<virtual_observer>
+    // one table of functions for each type of observer.
+    // the observer is held inline when it is small enough. a copy of a
+    // small observer is a copy, a large observer is shared, see
+    // inline_erased.
+    struct vtable
     {
-        virtual void on_next(T) const =0;
-        virtual void on_error(std::exception_ptr e) const =0;
-        virtual void on_completed() const =0;
+        void (*on_next_copy)(const void*, const T&);
+        void (*on_next_move)(const void*, T&&);
+        void (*on_error)(const void*, std::exception_ptr);
+        void (*on_completed)(const void*);
     };
 
     template<class Observer>
-    struct specific_observer : public virtual_observer
+    struct specific_observer
     {
-        explicit specific_observer(Observer o)
-            : destination(std::move(o))
-        {
+        static void on_next_copy(const void* d, const T& t) {
+            static_cast<const Observer*>(d)->on_next(t);
         }
-
-        Observer destination;
-        virtual void on_next(T t) const {
-            destination.on_next(std::move(t));
+        static void on_next_move(const void* d, T&& t) {
+            static_cast<const Observer*>(d)->on_next(std::move(t));
+        }
+        static void on_error(const void* d, std::exception_ptr e) {
+            static_cast<const Observer*>(d)->on_error(e);
         }
-        virtual void on_error(std::exception_ptr e) const {
-            destination.on_error(e);
+        static void on_completed(const void* d) {
+            static_cast<const Observer*>(d)->on_completed();
         }
-        virtual void on_completed() const {
-            destination.on_completed();
+        static const vtable* table() {
+            static const vtable t = {&on_next_copy, &on_next_move, &on_error, &on_completed};
+            return &t;
         }
     };
 
-    std::shared_ptr<virtual_observer> destination;
-
-    template<class Observer>
-    static auto make_destination(Observer o)
-        -> std::shared_ptr<virtual_observer> {
-        return std::make_shared<specific_observer<Observer>>(std::move(o));
-    }
+    rxu::detail::inline_erased<> destination;
+    const vtable* table;
 
 public:
     dynamic_observer()
+        : table(nullptr)
     {
     }
     dynamic_observer(const this_type& o)
         : destination(o.destination)
+        , table(o.table)
     {
     }
     dynamic_observer(this_type&& o)
         : destination(std::move(o.destination))
+        , table(o.table)
     {
+        o.table = nullptr;
     }
 
     template<class Observer>
     explicit dynamic_observer(Observer o)
-        : destination(make_destination(std::move(o)))
+        : table(specific_observer<Observer>::table())
     {
+        destination.template emplace<Observer>(std::move(o));
     }
 
     this_type& operator=(this_type o) {
         destination = std::move(o.destination);
+        table = o.table;
         return *this;
     }
 
-    // perfect forwarding delays the copy of the value.
-    template<class V>
-    void on_next(V&& v) const {
-        if (destination) {
-            destination->on_next(std::forward<V>(v));
+    void on_next(const T& t) const {
+        if (table) {
+            table->on_next_copy(destination.get(), t);
+        }
+    }
+    void on_next(T&& t) const {
+        if (table) {
+            table->on_next_move(destination.get(), std::move(t));
         }
     }
     void on_error(std::exception_ptr e) const {
-        if (destination) {
-            destination->on_error(e);
+        if (table) {
+            table->on_error(destination.get(), e);
         }
     }
     void on_completed() const {
-        if (destination) {
-            destination->on_completed();
+        if (table) {
+            table->on_completed(destination.get());
         }
     }
 };
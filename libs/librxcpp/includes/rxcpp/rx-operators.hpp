@@ -29,30 +29,119 @@ public:
     static const bool value = std::is_convertible<decltype(check<typename std::decay<T>::type>(0)), tag_operator*>::value;
 };
 
+namespace detail {
+
+// the state of an operator that is timed on the worker of a coordination.
+// Values holds the arguments of the operator and the coordination.
+template<class Values, class Coordination, class Subscriber>
+struct timed_state
+{
+    typedef typename std::decay<Coordination>::type coordination_type;
+    typedef typename coordination_type::coordinator_type coordinator_type;
+    typedef typename std::decay<Subscriber>::type dest_type;
+
+    timed_state(dest_type d, Values v, coordinator_type coor, composite_subscription cs)
+        : values(std::move(v))
+        , coordinator(std::move(coor))
+        , worker(coordinator.get_worker())
+        , lifetime(std::move(cs))
+        , dest(std::move(d))
+    {
+    }
+
+    Values values;
+    coordinator_type coordinator;
+    rxsc::worker worker;
+    // the subscription to the source
+    composite_subscription lifetime;
+    dest_type dest;
+
+    // f as a schedulable on the worker. empty when the coordinator threw,
+    // the error was sent to dest.
+    template<class F>
+    rxu::maybe<rxsc::schedulable> act(F f) {
+        auto selected = on_exception(
+            [&](){return coordinator.act(std::move(f));},
+            dest);
+        rxu::maybe<rxsc::schedulable> result;
+        if (!selected.empty()) {
+            result.reset(rxsc::make_schedulable(worker, selected.get()));
+        }
+        return result;
+    }
+
+    // runs f on the worker as soon as it is free
+    template<class F>
+    void schedule(F f) {
+        auto selected = act(std::move(f));
+        if (!selected.empty()) {
+            selected->schedule();
+        }
+    }
+};
+
+// creates the state of a timed operator for the destination d. the worker
+// runs until the destination unsubscribes, the source subscription ends
+// when the source completes. the destination keeps the state alive.
+template<class State, class Values, class Subscriber>
+std::shared_ptr<State> make_timed_state(Subscriber& d, Values v)
+{
+    auto coordinator = v.coordination.create_coordinator(d.get_subscription());
+    auto cs = composite_subscription();
+    d.add(cs);
+    auto state = std::make_shared<State>(d, std::move(v), std::move(coordinator), std::move(cs));
+    d.add([state](){});
+    return state;
+}
+
+// a schedulable that calls f(state, self) on the worker. it refers to the
+// state weakly, so that a pending timer does not keep it alive after the
+// destination unsubscribes.
+template<class State, class F>
+rxu::maybe<rxsc::schedulable> timed_action(const std::shared_ptr<State>& state, F f)
+{
+    std::weak_ptr<State> weak = state;
+    return state->act([weak, f](const rxsc::schedulable& self){
+        auto s = weak.lock();
+        if (s) {
+            f(*s, self);
+        }
+    });
+}
+
+}
+
 }
 namespace rxo=operators;
 
 }
 
 #include "operators/rx-buffer_count.hpp"
+#include "operators/rx-buffer_time.hpp"
 #include "operators/rx-combine_latest.hpp"
 #include "operators/rx-concat.hpp"
 #include "operators/rx-concat_map.hpp"
 #include "operators/rx-connect_forever.hpp"
+#include "operators/rx-debounce.hpp"
+#include "operators/rx-delay.hpp"
 #include "operators/rx-distinct_until_changed.hpp"
 #include "operators/rx-filter.hpp"
 #include "operators/rx-finally.hpp"
 #include "operators/rx-flat_map.hpp"
 #include "operators/rx-group_by.hpp"
+#include "operators/rx-group_by_hashed.hpp"
 #include "operators/rx-lift.hpp"
 #include "operators/rx-map.hpp"
 #include "operators/rx-merge.hpp"
 #include "operators/rx-multicast.hpp"
 #include "operators/rx-observe_on.hpp"
+#include "operators/rx-observe_on_bounded.hpp"
+#include "operators/rx-pipe.hpp"
 #include "operators/rx-publish.hpp"
 #include "operators/rx-reduce.hpp"
 #include "operators/rx-ref_count.hpp"
 #include "operators/rx-repeat.hpp"
+#include "operators/rx-sample.hpp"
 #include "operators/rx-scan.hpp"
 #include "operators/rx-skip.hpp"
 #include "operators/rx-skip_until.hpp"
@@ -62,6 +151,9 @@ namespace rxo=operators;
 #include "operators/rx-switch_on_next.hpp"
 #include "operators/rx-take.hpp"
 #include "operators/rx-take_until.hpp"
+#include "operators/rx-throttle_first.hpp"
+#include "operators/rx-timeout.hpp"
 #include "operators/rx-window.hpp"
+#include "operators/rx-window_time.hpp"
 #include "operators/rx-retry.hpp"
 #endif
@@ -868,6 +868,251 @@ public:
     }
 };
 
+// A hierarchical hashed timer wheel with the same interface as
+// schedulable_queue. push and pop are O(1) for items in the future.
+// items are ordered by the millisecond tick they fall in and in fifo order
+// within a tick, so every item due in the same tick is moved to the ready
+// list in one batch.
+template<class TimePoint>
+class timer_wheel {
+public:
+    typedef time_schedulable<TimePoint> item_type;
+    typedef const item_type& const_reference;
+
+private:
+    typedef std::chrono::milliseconds tick_duration;
+    static const int bits = 6;
+    static const int64_t slots = int64_t(1) << bits;
+    static const int64_t mask = slots - 1;
+    static const int levels = 4;
+
+    struct entry
+    {
+        entry(int64_t tick, uint64_t order, item_type item)
+            : tick(tick)
+            , order(order)
+            , item(std::move(item))
+        {
+        }
+        int64_t tick;
+        uint64_t order;
+        item_type item;
+    };
+    struct compare_entry
+    {
+        bool operator()(const entry& lhs, const entry& rhs) const {
+            return lhs.tick > rhs.tick || (lhs.tick == rhs.tick && lhs.order > rhs.order);
+        }
+    };
+    typedef std::vector<entry> slot_type;
+
+    // items in level L share all the tick bits above level L with
+    // cursor, so each level only holds items for its current rotation.
+    std::array<std::array<slot_type, slots>, levels> wheel;
+    std::array<size_t, levels> level_count;
+    // items beyond the range of the top level
+    slot_type overflow;
+    // items in the cursor tick, in fifo order
+    std::deque<entry> ready;
+    // items pushed with a tick before cursor
+    std::priority_queue<entry, std::vector<entry>, compare_entry> late;
+    int64_t cursor;
+    uint64_t order;
+    size_t count;
+
+    static int64_t tick_of(TimePoint when) {
+        return std::chrono::duration_cast<tick_duration>(when.time_since_epoch()).count();
+    }
+
+    void place(entry e) {
+        if (e.tick < cursor) {
+            late.push(std::move(e));
+            return;
+        }
+        if (e.tick == cursor) {
+            ready.push_back(std::move(e));
+            return;
+        }
+        for (int level = 0; level != levels; ++level) {
+            auto shift = bits * (level + 1);
+            if ((e.tick >> shift) == (cursor >> shift)) {
+                ++level_count[level];
+                wheel[level][(e.tick >> (bits * level)) & mask].push_back(std::move(e));
+                return;
+            }
+        }
+        overflow.push_back(std::move(e));
+    }
+
+    // move cursor forward to the next tick that has items and move
+    // those items to ready. only called when ready and late are empty.
+    void advance() {
+        while (ready.empty()) {
+            if (level_count[0] != 0) {
+                for (auto i = (cursor & mask) + 1; i != slots; ++i) {
+                    auto& slot = wheel[0][i];
+                    if (!slot.empty()) {
+                        cursor = (cursor & ~mask) | i;
+                        level_count[0] -= slot.size();
+                        ready.insert(ready.end(), std::make_move_iterator(slot.begin()), std::make_move_iterator(slot.end()));
+                        slot.clear();
+                        break;
+                    }
+                }
+                continue;
+            }
+            int level = 1;
+            while (level != levels && level_count[level] == 0) {
+                ++level;
+            }
+            if (level == levels) {
+                // only overflow items remain. restart the wheel at the earliest.
+                slot_type pending;
+                swap(pending, overflow);
+                cursor = std::min_element(pending.begin(), pending.end(),
+                    [](const entry& lhs, const entry& rhs){
+                        return lhs.tick < rhs.tick;
+                    })->tick;
+                for (auto& e : pending) {
+                    place(std::move(e));
+                }
+                continue;
+            }
+            auto shift = bits * level;
+            for (auto i = ((cursor >> shift) & mask) + 1; i != slots; ++i) {
+                auto& slot = wheel[level][i];
+                if (!slot.empty()) {
+                    // jump to the start of the slot and cascade its items down
+                    cursor = (((cursor >> shift) & ~mask) | i) << shift;
+                    level_count[level] -= slot.size();
+                    slot_type pending;
+                    swap(pending, slot);
+                    for (auto& e : pending) {
+                        place(std::move(e));
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+public:
+    timer_wheel()
+        : cursor(tick_of(TimePoint::clock::now()))
+        , order(0)
+        , count(0)
+    {
+        level_count.fill(0);
+    }
+
+    const_reference top() {
+        if (!late.empty()) {
+            return late.top().item;
+        }
+        if (ready.empty()) {
+            advance();
+        }
+        return ready.front().item;
+    }
+
+    void pop() {
+        if (!late.empty()) {
+            late.pop();
+        } else {
+            if (ready.empty()) {
+                advance();
+            }
+            ready.pop_front();
+        }
+        --count;
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    void push(const item_type& value) {
+        place(entry(tick_of(value.when), order++, value));
+        ++count;
+    }
+
+    void push(item_type&& value) {
+        auto tick = tick_of(value.when);
+        place(entry(tick, order++, std::move(value)));
+        ++count;
+    }
+};
+
+}
+
+/// selects the structure that a worker uses to order timed actions
+struct timer_kind
+{
+    enum type {
+        /// binary heap, O(log n) push and pop, exact time order
+        heap,
+        /// hashed timer wheel, O(1) push and pop, millisecond order
+        wheel
+    };
+};
+
+/// selects how a worker thread waits for the next action
+struct wait_kind
+{
+    enum type {
+        /// sleeps on a condition variable, every wake up is a system call
+        blocking,
+        /// spins for a few microseconds, then yields, then sleeps. a thread
+        /// that is scheduled soon after it went idle wakes without a
+        /// system call
+        spin_park,
+        /// never sleeps, the thread polls for actions and keeps its cpu
+        /// busy. only for a thread that has a core of its own
+        busy_poll
+    };
+};
+
+namespace detail {
+
+// holds the timed actions of a worker in the structure selected
+// for the scheduler.
+template<class TimePoint>
+class timed_queue {
+public:
+    typedef time_schedulable<TimePoint> item_type;
+    typedef const item_type& const_reference;
+
+private:
+    schedulable_queue<TimePoint> heap;
+    std::unique_ptr<timer_wheel<TimePoint>> wheel;
+
+public:
+    explicit timed_queue(timer_kind::type kind = timer_kind::heap)
+        : wheel(kind == timer_kind::wheel ? new timer_wheel<TimePoint>() : nullptr)
+    {
+    }
+
+    const_reference top() {
+        return wheel ? wheel->top() : heap.top();
+    }
+
+    void pop() {
+        wheel ? wheel->pop() : heap.pop();
+    }
+
+    bool empty() const {
+        return wheel ? wheel->empty() : heap.empty();
+    }
+
+    void push(const item_type& value) {
+        wheel ? wheel->push(value) : heap.push(value);
+    }
+
+    void push(item_type&& value) {
+        wheel ? wheel->push(std::move(value)) : heap.push(std::move(value));
+    }
+};
+
 }
 
 }
@@ -877,7 +1122,11 @@ namespace rxsc=schedulers;
 
 #include "schedulers/rx-currentthread.hpp"
 #include "schedulers/rx-newthread.hpp"
+#include "schedulers/rx-affinity.hpp"
+#include "schedulers/rx-pooledthread.hpp"
 #include "schedulers/rx-eventloop.hpp"
+#include "schedulers/rx-elasticloop.hpp"
+#include "schedulers/rx-workstealing.hpp"
 #include "schedulers/rx-immediate.hpp"
 #include "schedulers/rx-virtualtime.hpp"
 #include "schedulers/rx-sameworker.hpp"
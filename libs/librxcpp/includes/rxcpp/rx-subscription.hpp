@@ -7,6 +7,10 @@
 
 #include "rx-includes.hpp"
 
+#if !defined(RXCPP_COMPOSITE_INLINE_CHILDREN)
+#define RXCPP_COMPOSITE_INLINE_CHILDREN 4
+#endif
+
 namespace rxcpp {
 
 namespace detail {
@@ -64,8 +68,16 @@ public:
     }
 };
 
+namespace detail {
+class composite_subscription_inner;
+}
+
 class subscription : public subscription_base
 {
+    // the composite state is a subscription state, so that a composite
+    // subscription is one shared state and not two
+    friend class detail::composite_subscription_inner;
+
     class base_subscription_state : public std::enable_shared_from_this<base_subscription_state>
     {
         base_subscription_state();
@@ -116,6 +128,15 @@ private:
             abort();
         }
     }
+protected:
+    struct tag_state {};
+    subscription(std::shared_ptr<base_subscription_state> s, tag_state)
+        : state(std::move(s))
+    {
+        if (!state) {
+            abort();
+        }
+    }
 public:
 
     subscription()
@@ -127,7 +148,7 @@ public:
     }
     template<class U>
     explicit subscription(U u, typename std::enable_if<!is_subscription<U>::value, void**>::type = nullptr)
-        : state(std::make_shared<subscription_state<U>>(std::move(u)))
+        : state(std::allocate_shared<subscription_state<U>>(rxu::detail::pooled_allocator<subscription_state<U>>(), std::move(u)))
     {
         if (!state) {
             abort();
@@ -218,67 +239,135 @@ class composite_subscription_inner
 {
 private:
     typedef subscription::weak_state_type weak_subscription;
-    struct composite_subscription_state : public std::enable_shared_from_this<composite_subscription_state>
-    {
-        std::set<subscription> subscriptions;
-        std::mutex lock;
-        std::atomic<bool> issubscribed;
+    typedef subscription::base_subscription_state base_state_type;
+    typedef std::shared_ptr<base_state_type> child_type;
+    typedef std::set<child_type> overflow_type;
 
-        ~composite_subscription_state()
-        {
-            std::unique_lock<decltype(lock)> guard(lock);
-            subscriptions.clear();
+    // the children taken out by clear or unsubscribe
+    struct detached_children
+    {
+        child_type inline_children[RXCPP_COMPOSITE_INLINE_CHILDREN];
+        overflow_type overflow;
+
+        void unsubscribe() {
+            for (auto& c : inline_children) {
+                if (c) {
+                    c->unsubscribe();
+                }
+            }
+            for (auto& c : overflow) {
+                c->unsubscribe();
+            }
         }
+    };
+
+    // the composite is its own subscription state. the first children are
+    // held inline and only the children past those allocate. the lock is
+    // held to move a few pointers, children are unsubscribed and released
+    // outside of it.
+    struct composite_subscription_state : public base_state_type
+    {
+        child_type inline_children[RXCPP_COMPOSITE_INLINE_CHILDREN];
+        std::size_t inline_count;
+        overflow_type overflow;
+        rxu::detail::spin_lock lock;
 
         composite_subscription_state()
-            : issubscribed(true)
+            : base_state_type(true)
+            , inline_count(0)
         {
         }
         composite_subscription_state(tag_composite_subscription_empty)
-            : issubscribed(false)
+            : base_state_type(false)
+            , inline_count(0)
         {
         }
 
         inline weak_subscription add(subscription s) {
-            if (!issubscribed) {
-                s.unsubscribe();
-            } else if (s.is_subscribed()) {
+            weak_subscription w(s.state);
+            if (s.is_subscribed()) {
                 std::unique_lock<decltype(lock)> guard(lock);
-                subscriptions.insert(s);
+                // checked under the lock so that a child is never added
+                // after unsubscribe took the children
+                if (issubscribed) {
+                    insert(std::move(s.state));
+                    return w;
+                }
             }
-            return s.get_weak();
+            s.unsubscribe();
+            return w;
         }
 
         inline void remove(weak_subscription w) {
             if (issubscribed && !w.expired()) {
-                auto s = subscription::lock(w);
+                // released after the lock
+                child_type removed;
                 std::unique_lock<decltype(lock)> guard(lock);
-                subscriptions.erase(std::move(s));
+                for (std::size_t i = 0; i != inline_count; ++i) {
+                    if (!w.owner_before(inline_children[i]) && !inline_children[i].owner_before(w)) {
+                        removed = std::move(inline_children[i]);
+                        inline_children[i] = std::move(inline_children[--inline_count]);
+                        return;
+                    }
+                }
+                if (!overflow.empty()) {
+                    removed = w.lock();
+                    if (removed) {
+                        overflow.erase(removed);
+                    }
+                }
             }
         }
 
         inline void clear() {
             if (issubscribed) {
-                std::unique_lock<decltype(lock)> guard(lock);
-
-                std::set<subscription> v(std::move(subscriptions));
-                guard.unlock();
-                std::for_each(v.begin(), v.end(),
-                              [](const subscription& s) {
-                                s.unsubscribe(); });
+                detached_children v;
+                {
+                    std::unique_lock<decltype(lock)> guard(lock);
+                    detach(v);
+                }
+                v.unsubscribe();
             }
         }
 
-        inline void unsubscribe() {
+        virtual void unsubscribe() {
             if (issubscribed.exchange(false)) {
-                std::unique_lock<decltype(lock)> guard(lock);
+                trace_activity().unsubscribe_enter(*this);
+                detached_children v;
+                {
+                    std::unique_lock<decltype(lock)> guard(lock);
+                    detach(v);
+                }
+                v.unsubscribe();
+                trace_activity().unsubscribe_return(*this);
+            }
+        }
+
+    private:
+        // must be called with lock held
+        void insert(child_type c) {
+            for (std::size_t i = 0; i != inline_count; ++i) {
+                if (inline_children[i] == c) {
+                    return;
+                }
+            }
+            if (!overflow.empty() && overflow.count(c) != 0) {
+                return;
+            }
+            if (inline_count < RXCPP_COMPOSITE_INLINE_CHILDREN) {
+                inline_children[inline_count++] = std::move(c);
+            } else {
+                overflow.insert(std::move(c));
+            }
+        }
 
-                std::set<subscription> v(std::move(subscriptions));
-                guard.unlock();
-                std::for_each(v.begin(), v.end(),
-                              [](const subscription& s) {
-                                s.unsubscribe(); });
+        // must be called with lock held
+        void detach(detached_children& v) {
+            for (std::size_t i = 0; i != inline_count; ++i) {
+                v.inline_children[i] = std::move(inline_children[i]);
             }
+            inline_count = 0;
+            v.overflow.swap(overflow);
         }
     };
 
@@ -290,11 +379,11 @@ protected:
 
 public:
     composite_subscription_inner()
-        : state(std::make_shared<composite_subscription_state>())
+        : state(std::allocate_shared<composite_subscription_state>(rxu::detail::pooled_allocator<composite_subscription_state>()))
     {
     }
     composite_subscription_inner(tag_composite_subscription_empty et)
-        : state(std::make_shared<composite_subscription_state>(et))
+        : state(std::allocate_shared<composite_subscription_state>(rxu::detail::pooled_allocator<composite_subscription_state>(), et))
     {
     }
 
@@ -362,7 +451,7 @@ public:
 
     composite_subscription(detail::tag_composite_subscription_empty et)
         : inner_type(et)
-        , subscription() // use empty base
+        , subscription(inner_type::state, tag_state())
     {
     }
 
@@ -370,7 +459,7 @@ public:
 
     composite_subscription()
         : inner_type()
-        , subscription(*static_cast<const inner_type* const>(this))
+        , subscription(inner_type::state, tag_state())
     {
     }
 
@@ -427,7 +427,7 @@ public:
     }
     const T* operator->() const {
         if (!is_set) abort();
-        return reinterpret_cast<T*>(&storage);
+        return reinterpret_cast<const T*>(&storage);
     }
 
     T& operator*() {
@@ -541,6 +541,321 @@ private:
 
 }
 
+namespace detail {
+
+/// cpu_relax tells the cpu that the thread is in a spin wait, so that it
+/// does not starve the other hardware thread of the core or burn power.
+inline void cpu_relax() {
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+    _mm_pause();
+#elif defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+    __builtin_ia32_pause();
+#elif defined(__GNUC__) && (defined(__aarch64__) || defined(__arm__))
+    __asm__ __volatile__("yield");
+#endif
+}
+
+/// spin_lock guards a critical section that is a few instructions long. a
+/// waiter spins and then yields, it does not sleep.
+class spin_lock
+{
+    std::atomic_flag flag;
+
+    spin_lock(const spin_lock&);
+    spin_lock& operator=(const spin_lock&);
+public:
+    spin_lock()
+    {
+        flag.clear();
+    }
+    void lock() {
+        for (int spins = 0; flag.test_and_set(std::memory_order_acquire); ++spins) {
+            if (spins >= 64) {
+                std::this_thread::yield();
+            } else {
+                cpu_relax();
+            }
+        }
+    }
+    bool try_lock() {
+        return !flag.test_and_set(std::memory_order_acquire);
+    }
+    void unlock() {
+        flag.clear(std::memory_order_release);
+    }
+};
+
+}
+
+#if !defined(RXCPP_POOL_CACHE_SIZE)
+#define RXCPP_POOL_CACHE_SIZE 32
+#endif
+
+namespace detail {
+
+// the blocks of one size that a thread freed, kept for the next allocation
+// on the same thread. a block freed on another thread goes to the cache of
+// that thread. the cache is released when the thread exits.
+// without thread_local the cache could not be released, so nothing is kept.
+template<class Block>
+struct pool_cache
+{
+    static RXCPP_THREAD_LOCAL void* head;
+    static RXCPP_THREAD_LOCAL std::size_t count;
+    // set when the thread has released the cache
+    static RXCPP_THREAD_LOCAL bool retired;
+
+    struct reaper
+    {
+        ~reaper()
+        {
+            retired = true;
+            while (head) {
+                void* p = head;
+                head = *static_cast<void**>(p);
+                ::operator delete(p);
+            }
+            count = 0;
+        }
+    };
+
+    static void* take() {
+        void* p = head;
+        if (p) {
+            head = *static_cast<void**>(p);
+            --count;
+        }
+        return p;
+    }
+    static bool give(void* p) {
+#if RXCPP_USE_THREAD_LOCAL
+        if (retired || count >= RXCPP_POOL_CACHE_SIZE) {
+            return false;
+        }
+        if (count == 0) {
+            // registers the release of the cache at thread exit
+            static thread_local reaper r;
+            (void)r;
+        }
+        *static_cast<void**>(p) = head;
+        head = p;
+        ++count;
+        return true;
+#else
+        (void)p;
+        return false;
+#endif
+    }
+};
+
+template<class Block>
+RXCPP_THREAD_LOCAL void* pool_cache<Block>::head = nullptr;
+template<class Block>
+RXCPP_THREAD_LOCAL std::size_t pool_cache<Block>::count = 0;
+template<class Block>
+RXCPP_THREAD_LOCAL bool pool_cache<Block>::retired = false;
+
+/// pooled_allocator allocates single objects from a small per-thread cache
+/// of freed blocks. it is meant for std::allocate_shared of states that are
+/// created and released at a high rate.
+template<class T>
+struct pooled_allocator
+{
+    typedef T value_type;
+
+    pooled_allocator()
+    {
+    }
+    template<class U>
+    pooled_allocator(const pooled_allocator<U>&)
+    {
+    }
+
+    T* allocate(std::size_t n) {
+        if (n == 1) {
+            void* p = pool_cache<T>::take();
+            if (p) {
+                return static_cast<T*>(p);
+            }
+        }
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+    void deallocate(T* p, std::size_t n) {
+        if (n == 1 && sizeof(T) >= sizeof(void*) && pool_cache<T>::give(p)) {
+            return;
+        }
+        ::operator delete(p);
+    }
+};
+template<class T, class U>
+bool operator==(const pooled_allocator<T>&, const pooled_allocator<U>&) {
+    return true;
+}
+template<class T, class U>
+bool operator!=(const pooled_allocator<T>&, const pooled_allocator<U>&) {
+    return false;
+}
+
+}
+
+#if !defined(RXCPP_INLINE_ERASED_SIZE)
+#define RXCPP_INLINE_ERASED_SIZE (6 * sizeof(void*))
+#endif
+
+namespace detail {
+
+/// inline_erased holds one object of any type. an object that fits in Size
+/// bytes is held inline, so holding it does not allocate. a larger object is held by a shared_ptr, so a copy
+/// is a reference count and not a copy of the object.
+/// so whether copies share the object depends on its size: a copy of a
+/// small object is a new object, a copy of a large one is the same object.
+/// an object whose copies must see the same changes has to keep that state
+/// behind a shared_ptr itself, as the sources, operators and subscribers do.
+template<std::size_t Size = RXCPP_INLINE_ERASED_SIZE>
+class inline_erased
+{
+    typedef typename std::aligned_storage<Size>::type storage_type;
+
+    struct manager_type
+    {
+        void (*copy)(const storage_type& from, storage_type& to);
+        void (*move)(storage_type& from, storage_type& to);
+        void (*destroy)(storage_type& s);
+        void* (*target)(storage_type& s);
+    };
+
+    template<class U>
+    struct held_inline
+    {
+        static void copy(const storage_type& from, storage_type& to) {
+            new (&to) U(*reinterpret_cast<const U*>(&from));
+        }
+        static void move(storage_type& from, storage_type& to) {
+            new (&to) U(std::move(*reinterpret_cast<U*>(&from)));
+        }
+        static void destroy(storage_type& s) {
+            reinterpret_cast<U*>(&s)->~U();
+        }
+        static void* target(storage_type& s) {
+            return &s;
+        }
+        static const manager_type* manager() {
+            static const manager_type m = {&copy, &move, &destroy, &target};
+            return &m;
+        }
+        template<class V>
+        static void construct(storage_type& s, V&& v) {
+            new (&s) U(std::forward<V>(v));
+        }
+    };
+
+    template<class U>
+    struct held_shared
+    {
+        typedef std::shared_ptr<U> pointer_type;
+        static void copy(const storage_type& from, storage_type& to) {
+            new (&to) pointer_type(*reinterpret_cast<const pointer_type*>(&from));
+        }
+        static void move(storage_type& from, storage_type& to) {
+            new (&to) pointer_type(std::move(*reinterpret_cast<pointer_type*>(&from)));
+        }
+        static void destroy(storage_type& s) {
+            reinterpret_cast<pointer_type*>(&s)->~pointer_type();
+        }
+        static void* target(storage_type& s) {
+            return reinterpret_cast<pointer_type*>(&s)->get();
+        }
+        static const manager_type* manager() {
+            static const manager_type m = {&copy, &move, &destroy, &target};
+            return &m;
+        }
+        template<class V>
+        static void construct(storage_type& s, V&& v) {
+            new (&s) pointer_type(std::make_shared<U>(std::forward<V>(v)));
+        }
+    };
+
+    storage_type storage;
+    const manager_type* manager;
+    // the held object
+    void* held;
+
+public:
+    template<class U>
+    struct is_inline
+    {
+        static const bool value = sizeof(U) <= sizeof(storage_type) &&
+            std::alignment_of<U>::value <= std::alignment_of<storage_type>::value;
+    };
+
+    ~inline_erased()
+    {
+        reset();
+    }
+    inline_erased()
+        : manager(nullptr)
+        , held(nullptr)
+    {
+    }
+    inline_erased(const inline_erased& o)
+        : manager(o.manager)
+        , held(nullptr)
+    {
+        if (manager) {
+            manager->copy(o.storage, storage);
+            held = manager->target(storage);
+        }
+    }
+    inline_erased(inline_erased&& o)
+        : manager(o.manager)
+        , held(nullptr)
+    {
+        if (manager) {
+            manager->move(o.storage, storage);
+            held = manager->target(storage);
+            o.reset();
+        }
+    }
+    inline_erased& operator=(inline_erased o) {
+        reset();
+        if (o.manager) {
+            o.manager->move(o.storage, storage);
+            manager = o.manager;
+            held = manager->target(storage);
+            o.reset();
+        }
+        return *this;
+    }
+
+    /// replaces the held object with a U constructed from v and returns it
+    template<class U, class V>
+    U* emplace(V&& v) {
+        typedef typename std::conditional<is_inline<U>::value, held_inline<U>, held_shared<U>>::type holder;
+        reset();
+        holder::construct(storage, std::forward<V>(v));
+        manager = holder::manager();
+        held = manager->target(storage);
+        return static_cast<U*>(held);
+    }
+
+    void reset() {
+        if (manager) {
+            manager->destroy(storage);
+            manager = nullptr;
+            held = nullptr;
+        }
+    }
+
+    bool empty() const {
+        return !manager;
+    }
+    void* get() const {
+        return held;
+    }
+};
+
+}
+
 }
 namespace rxu=util;
 
@@ -0,0 +1,203 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved. See License.txt in the project root for license information.
+
+#pragma once
+
+#if !defined(RXCPP_RX_SCHEDULER_AFFINITY_HPP)
+#define RXCPP_RX_SCHEDULER_AFFINITY_HPP
+
+#include "../rx-includes.hpp"
+
+#include <cstdlib>
+#include <sstream>
+#include <string>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <fstream>
+#elif defined(__APPLE__)
+#include <pthread.h>
+#endif
+
+// thread_factory presets that name their threads and pin them to cpus.
+// threads are pinned on linux. other platforms name the threads where
+// they can and ignore the cpus.
+
+namespace rxcpp {
+
+namespace schedulers {
+
+namespace detail {
+
+// parses a cpu list such as "0-3,8,10-11"
+inline std::vector<unsigned> parse_cpu_list(const std::string& list) {
+    std::vector<unsigned> cpus;
+    size_t at = 0;
+    while (at < list.size()) {
+        auto end = list.find(',', at);
+        if (end == std::string::npos) {
+            end = list.size();
+        }
+        auto range = list.substr(at, end - at);
+        auto dash = range.find('-');
+        char* last = nullptr;
+        unsigned first = static_cast<unsigned>(std::strtoul(range.c_str(), &last, 10));
+        if (last != range.c_str()) {
+            unsigned final = dash == std::string::npos ? first : static_cast<unsigned>(std::strtoul(range.c_str() + dash + 1, nullptr, 10));
+            for (unsigned cpu = first; cpu <= final; ++cpu) {
+                cpus.push_back(cpu);
+            }
+        }
+        at = end + 1;
+    }
+    return cpus;
+}
+
+// reads a cpu list from a sysfs file, empty when there is no such file
+inline std::vector<unsigned> read_cpu_list(const std::string& path) {
+#if defined(__linux__)
+    std::ifstream file(path.c_str());
+    std::string list;
+    if (file && std::getline(file, list)) {
+        return parse_cpu_list(list);
+    }
+#else
+    (void)path;
+#endif
+    return std::vector<unsigned>();
+}
+
+// restricts the calling thread to cpus, an empty list leaves it as it is
+inline void pin_current_thread(const std::vector<unsigned>& cpus) {
+#if defined(__linux__)
+    if (cpus.empty()) {
+        return;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (auto cpu : cpus) {
+        if (cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &set);
+        }
+    }
+    // best effort, a cpu outside of the process affinity is an error that
+    // leaves the thread where it was
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)cpus;
+#endif
+}
+
+inline void name_current_thread(const std::string& name) {
+#if defined(__linux__)
+    // linux names are at most 15 characters
+    pthread_setname_np(pthread_self(), name.substr(0, 15).c_str());
+#elif defined(__APPLE__)
+    pthread_setname_np(name.c_str());
+#else
+    (void)name;
+#endif
+}
+
+// creates thread n with the name name-n on the cpus selected for it
+inline thread_factory make_placed_thread_factory(std::string name, std::function<std::vector<unsigned>(size_t)> place) {
+    auto created = std::make_shared<std::atomic<size_t>>(0);
+    return [name, place, created](std::function<void()> start){
+        size_t n = (*created)++;
+        auto cpus = place(n);
+        std::ostringstream threadname;
+        threadname << name << "-" << n;
+        auto named = threadname.str();
+        return std::thread([named, cpus, start](){
+            name_current_thread(named);
+            pin_current_thread(cpus);
+            start();
+        });
+    };
+}
+
+}
+
+/// the cpus in the machine
+inline std::vector<unsigned> all_cpus() {
+    auto cpus = detail::read_cpu_list("/sys/devices/system/cpu/online");
+    if (cpus.empty()) {
+        for (unsigned cpu = 0; cpu != std::max(std::thread::hardware_concurrency(), unsigned(1)); ++cpu) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+/// one cpu of each physical core, the hyperthreads of a core are left out
+inline std::vector<unsigned> physical_cores() {
+    std::vector<unsigned> cores;
+    for (auto cpu : all_cpus()) {
+        std::ostringstream path;
+        path << "/sys/devices/system/cpu/cpu" << cpu << "/topology/thread_siblings_list";
+        auto siblings = detail::read_cpu_list(path.str());
+        // the first sibling stands for the core
+        if (siblings.empty() || *std::min_element(siblings.begin(), siblings.end()) == cpu) {
+            cores.push_back(cpu);
+        }
+    }
+    return cores;
+}
+
+/// the numa nodes in the machine, {0} when there is no numa information
+inline std::vector<unsigned> numa_nodes() {
+    auto nodes = detail::read_cpu_list("/sys/devices/system/node/online");
+    if (nodes.empty()) {
+        nodes.push_back(0);
+    }
+    return nodes;
+}
+
+/// the cpus of a numa node. without numa information node 0 has all cpus
+inline std::vector<unsigned> numa_node_cpus(unsigned node) {
+    std::ostringstream path;
+    path << "/sys/devices/system/node/node" << node << "/cpulist";
+    auto cpus = detail::read_cpu_list(path.str());
+    if (cpus.empty() && node == 0) {
+        cpus = all_cpus();
+    }
+    return cpus;
+}
+
+/// threads are named name-0, name-1, ..
+inline thread_factory make_named_thread_factory(std::string name) {
+    return detail::make_placed_thread_factory(std::move(name), [](size_t){
+        return std::vector<unsigned>();
+    });
+}
+
+/// thread n is named name-n and pinned to cpus[n % cpus.size()]. an event
+/// loop that creates its loops with this factory has loop n on cpus[n].
+inline thread_factory make_pinned_thread_factory(std::vector<unsigned> cpus, std::string name) {
+    return detail::make_placed_thread_factory(std::move(name), [cpus](size_t n){
+        return cpus.empty() ? cpus : std::vector<unsigned>(1, cpus[n % cpus.size()]);
+    });
+}
+
+/// threads are named name-n and may run on any of cpus, but no other cpu
+inline thread_factory make_cpu_group_thread_factory(std::vector<unsigned> cpus, std::string name) {
+    return detail::make_placed_thread_factory(std::move(name), [cpus](size_t){
+        return cpus;
+    });
+}
+
+/// one thread on each physical core, in turn
+inline thread_factory make_physical_core_thread_factory(std::string name) {
+    return make_pinned_thread_factory(physical_cores(), std::move(name));
+}
+
+/// threads stay on the cpus of the numa node, near the memory they allocate
+inline thread_factory make_numa_node_thread_factory(unsigned node, std::string name) {
+    return make_cpu_group_thread_factory(numa_node_cpus(node), std::move(name));
+}
+
+}
+
+}
+
+#endif
@@ -23,10 +23,63 @@ struct action_queue
 private:
     typedef schedulable_queue<item_type::time_point_type> queue_item_time;
 
+    // a fifo in a ring that keeps its storage when it is emptied
+    class immediate_queue
+    {
+        typedef rxu::detail::maybe<item_type> slot_type;
+        std::vector<slot_type> ring;
+        size_t head;
+        size_t count;
+
+        void grow() {
+            std::vector<slot_type> larger(std::max(ring.size() * 2, size_t(16)));
+            for (size_t i = 0; i != count; ++i) {
+                larger[i].reset(std::move(ring[(head + i) % ring.size()].get()));
+            }
+            ring.swap(larger);
+            head = 0;
+        }
+
+    public:
+        immediate_queue()
+            : head(0)
+            , count(0)
+        {
+        }
+
+        bool empty() const {
+            return count == 0;
+        }
+        const item_type& front() const {
+            return ring[head].get();
+        }
+        void push_back(item_type item) {
+            if (count == ring.size()) {
+                grow();
+            }
+            ring[(head + count) % ring.size()].reset(std::move(item));
+            ++count;
+        }
+        void pop_front() {
+            ring[head].reset();
+            head = (head + 1) % ring.size();
+            --count;
+        }
+        void clear() {
+            while (count != 0) {
+                pop_front();
+            }
+        }
+    };
+
 public:
     struct current_thread_queue_type {
         std::shared_ptr<worker_interface> w;
         recursion r;
+        // actions scheduled for now, in the order they were scheduled. the
+        // times only increase, so the lane stays sorted without a heap
+        immediate_queue immediate;
+        // actions scheduled for a time point
         queue_item_time queue;
     };
 
@@ -36,6 +89,33 @@ private:
         return queue;
     }
 
+    // the queue of the last trampoline on this thread, kept for the next one
+    static current_thread_queue_type*& spare_queue() {
+        static RXCPP_THREAD_LOCAL current_thread_queue_type* queue;
+        return queue;
+    }
+    // set when the thread has released the spare queue
+    static bool& spare_retired() {
+        static RXCPP_THREAD_LOCAL bool retired;
+        return retired;
+    }
+
+    struct spare_reaper
+    {
+        ~spare_reaper()
+        {
+            spare_retired() = true;
+            delete spare_queue();
+            spare_queue() = nullptr;
+        }
+    };
+
+    // true when the next action is in the timed queue
+    static bool next_is_timed(const current_thread_queue_type& state) {
+        return state.immediate.empty() ||
+            (!state.queue.empty() && state.queue.top().when < state.immediate.front().when);
+    }
+
 public:
 
     static bool owned() {
@@ -48,24 +128,30 @@ public:
         return current_thread_queue()->r;
     }
     static bool empty() {
-        if (!current_thread_queue()) {
+        auto state = current_thread_queue();
+        if (!state) {
             abort();
         }
-        return current_thread_queue()->queue.empty();
+        return state->immediate.empty() && state->queue.empty();
     }
-    static queue_item_time::const_reference top() {
-        if (!current_thread_queue()) {
+    static const item_type& top() {
+        auto state = current_thread_queue();
+        if (!state) {
             abort();
         }
-        return current_thread_queue()->queue.top();
+        return next_is_timed(*state) ? state->queue.top() : state->immediate.front();
     }
     static void pop() {
         auto state = current_thread_queue();
         if (!state) {
             abort();
         }
-        state->queue.pop();
-        if (state->queue.empty()) {
+        if (next_is_timed(*state)) {
+            state->queue.pop();
+        } else {
+            state->immediate.pop_front();
+        }
+        if (state->immediate.empty() && state->queue.empty()) {
             // allow recursion
             state->r.reset(true);
         }
@@ -82,14 +168,33 @@ public:
         // disallow recursion
         state->r.reset(false);
     }
+    /// queue an action to run as soon as the actions before it have run
+    static void push(const schedulable& scbl) {
+        auto state = current_thread_queue();
+        if (!state) {
+            abort();
+        }
+        if (!scbl.is_subscribed()) {
+            return;
+        }
+        state->immediate.push_back(item_type(clock::now(), scbl));
+        // disallow recursion
+        state->r.reset(false);
+    }
     static std::shared_ptr<worker_interface> ensure(std::shared_ptr<worker_interface> w) {
         if (!!current_thread_queue()) {
             abort();
         }
-        // create and publish new queue
-        current_thread_queue() = new current_thread_queue_type();
-        current_thread_queue()->w = w;
-        return w;
+        // reuse the queue of the last trampoline, its storage is allocated
+        auto queue = spare_queue();
+        spare_queue() = nullptr;
+        if (!queue) {
+            queue = new current_thread_queue_type();
+        }
+        queue->w = std::move(w);
+        // publish queue
+        current_thread_queue() = queue;
+        return queue->w;
     }
     static std::unique_ptr<current_thread_queue_type> create(std::shared_ptr<worker_interface> w) {
         std::unique_ptr<current_thread_queue_type> result(new current_thread_queue_type());
@@ -107,11 +212,34 @@ public:
         delete queue;
     }
     static void destroy() {
-        if (!current_thread_queue()) {
+        auto queue = current_thread_queue();
+        if (!queue) {
             abort();
         }
-        destroy(current_thread_queue());
         current_thread_queue() = nullptr;
+
+        // release the worker and the actions that were not run
+        queue->w.reset();
+        queue->immediate.clear();
+        while (!queue->queue.empty()) {
+            queue->queue.pop();
+        }
+        queue->r.reset(true);
+
+#if RXCPP_USE_THREAD_LOCAL
+        if (spare_retired() || !!spare_queue()) {
+            destroy(queue);
+            return;
+        }
+        // registers the release of the spare queue at thread exit
+        static thread_local spare_reaper reaper;
+        (void)reaper;
+        spare_queue() = queue;
+#else
+        // without thread_local the spare queue could not be released at
+        // thread exit, so it is not kept
+        destroy(queue);
+#endif
     }
 };
 
@@ -144,7 +272,7 @@ private:
         }
 
         virtual void schedule(const schedulable& scbl) const {
-            queue::push(queue::item_type(now(), scbl));
+            queue::push(scbl);
         }
 
         virtual void schedule(clock_type::time_point when, const schedulable& scbl) const {
@@ -152,6 +280,12 @@ private:
         }
     };
 
+    // the derecurser has no state, every trampoline shares one
+    static const std::shared_ptr<worker_interface>& shared_derecurser() {
+        static std::shared_ptr<worker_interface> d = std::make_shared<derecurser>();
+        return d;
+    }
+
     struct current_worker : public worker_interface
     {
     private:
@@ -170,6 +304,14 @@ private:
         }
 
         virtual void schedule(const schedulable& scbl) const {
+            if (queue::owned()) {
+                // already has an owner - delegate without a time, so that
+                // the owner can queue it in order
+                if (scbl.is_subscribed()) {
+                    queue::get_worker_interface()->schedule(scbl);
+                }
+                return;
+            }
             schedule(now(), scbl);
         }
 
@@ -187,7 +329,7 @@ private:
                 }
 
                 // take ownership
-                queue::ensure(std::make_shared<derecurser>());
+                queue::ensure(shared_derecurser());
             }
             // release ownership
             RXCPP_UNWIND_AUTO([]{
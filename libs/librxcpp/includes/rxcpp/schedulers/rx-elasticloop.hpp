@@ -0,0 +1,440 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved. See License.txt in the project root for license information.
+
+#pragma once
+
+#if !defined(RXCPP_RX_SCHEDULER_ELASTIC_LOOP_HPP)
+#define RXCPP_RX_SCHEDULER_ELASTIC_LOOP_HPP
+
+#include "../rx-includes.hpp"
+
+namespace rxcpp {
+
+namespace schedulers {
+
+/// event_loop_counters reports the threads of every elastic_event_loop that
+/// it is passed to.
+class event_loop_counters
+{
+    struct state_type
+    {
+        state_type()
+            : threads(0)
+            , started(0)
+            , retired(0)
+            , wakeups(0)
+            , spin_hits(0)
+        {
+        }
+        std::atomic<size_t> threads;
+        std::atomic<size_t> started;
+        std::atomic<size_t> retired;
+        std::atomic<size_t> wakeups;
+        std::atomic<size_t> spin_hits;
+    };
+    std::shared_ptr<state_type> state;
+
+public:
+    event_loop_counters()
+        : state(std::make_shared<state_type>())
+    {
+    }
+
+    /// the number of loop threads that are running
+    size_t threads() const {
+        return state->threads;
+    }
+    /// the number of loop threads that have been started
+    size_t started() const {
+        return state->started;
+    }
+    /// the number of loop threads that exited after being idle
+    size_t retired() const {
+        return state->retired;
+    }
+    /// the number of times a sleeping loop thread was woken for an action
+    size_t wakeups() const {
+        return state->wakeups;
+    }
+    /// the number of times a loop thread found an action while spinning
+    size_t spin_hits() const {
+        return state->spin_hits;
+    }
+
+    void thread_started() const {
+        ++state->threads;
+        ++state->started;
+    }
+    void thread_exited(bool idle) const {
+        --state->threads;
+        if (idle) {
+            ++state->retired;
+        }
+    }
+    void woke() const {
+        ++state->wakeups;
+    }
+    void spun() const {
+        ++state->spin_hits;
+    }
+};
+
+/// elastic_event_loop runs workers on up to max_threads loop threads, like
+/// event_loop, but a loop thread is only started when an action is
+/// scheduled on it. a new worker is placed on the loop with the fewest
+/// workers, so a few workers use a few threads.
+/// a loop thread with nothing to do spins for spin before it sleeps (there
+/// is no spin on a single cpu) and exits after idle_timeout, it is started
+/// again by the next action.
+struct elastic_event_loop : public scheduler_interface
+{
+private:
+    typedef elastic_event_loop this_type;
+    elastic_event_loop(const this_type&);
+
+    struct loop_state : public std::enable_shared_from_this<loop_state>
+    {
+        typedef detail::timed_queue<
+            typename clock_type::time_point> queue_item_time;
+
+        typedef queue_item_time::item_type item_type;
+
+        loop_state(thread_factory tf, clock_type::duration idle_timeout, clock_type::duration spin, event_loop_counters counters)
+            : factory(std::move(tf))
+            , idle_timeout(idle_timeout)
+            , spin(spin)
+            , counters(std::move(counters))
+            , workers(0)
+            , queue(timer_kind::heap)
+            , queued(0)
+            , running(false)
+            , sleeping(false)
+            , stopping(false)
+        {
+        }
+
+        thread_factory factory;
+        const clock_type::duration idle_timeout;
+        const clock_type::duration spin;
+        event_loop_counters counters;
+
+        // the workers placed on this loop
+        std::atomic<size_t> workers;
+        // the lifetimes of the actions that are queued are added to it
+        composite_subscription lifetime;
+
+        mutable std::mutex lock;
+        mutable std::condition_variable wake;
+        mutable queue_item_time queue;
+        // the size of queue, read without the lock while spinning
+        std::atomic<size_t> queued;
+        recursion r;
+        // true while a thread serves the loop
+        bool running;
+        // true while the thread waits on wake
+        bool sleeping;
+        bool stopping;
+
+        // guards thread
+        std::mutex start_lock;
+        std::thread thread;
+
+        void push(clock_type::time_point when, const schedulable& scbl) {
+            std::unique_lock<std::mutex> guard(lock);
+            queue.push(item_type(when, scbl));
+            ++queued;
+            r.reset(false);
+            if (sleeping) {
+                // a spinning or running thread does not need a notify. the
+                // notify is after unlock so the thread does not wake into
+                // the held lock
+                guard.unlock();
+                wake.notify_one();
+                counters.woke();
+                return;
+            }
+            if (running || stopping) {
+                return;
+            }
+            running = true;
+            guard.unlock();
+            start();
+        }
+
+        void start() {
+            std::unique_lock<std::mutex> starting(start_lock);
+            {
+                std::unique_lock<std::mutex> guard(lock);
+                if (stopping) {
+                    running = false;
+                    return;
+                }
+            }
+            if (thread.joinable()) {
+                // the previous thread retired and is exiting
+                thread.detach();
+            }
+            auto keepAlive = this->shared_from_this();
+            counters.thread_started();
+            thread = factory([keepAlive](){
+                keepAlive->run();
+            });
+        }
+
+        // returns true when an action was queued before spin elapsed
+        bool spin_for_action() const {
+            if (spin <= clock_type::duration::zero()) {
+                return false;
+            }
+            auto until = clock_type::now() + spin;
+            do {
+                if (queued != 0) {
+                    return true;
+                }
+                std::this_thread::yield();
+            } while (clock_type::now() < until);
+            return queued != 0;
+        }
+
+        void run();
+
+        void stop() {
+            {
+                std::unique_lock<std::mutex> guard(lock);
+                stopping = true;
+                if (sleeping) {
+                    wake.notify_one();
+                }
+            }
+            std::thread stopped;
+            {
+                // the lock is not held while joining, a retiring thread
+                // takes it to detach itself
+                std::unique_lock<std::mutex> starting(start_lock);
+                stopped = std::move(thread);
+            }
+            if (stopped.joinable()) {
+                if (stopped.get_id() == std::this_thread::get_id()) {
+                    stopped.detach();
+                } else {
+                    stopped.join();
+                }
+            }
+        }
+    };
+
+    // queues the actions on the loop, shared by the workers of the loop
+    struct loop_controller : public worker_interface
+    {
+    private:
+        typedef loop_controller this_type;
+        loop_controller(const this_type&);
+
+        std::shared_ptr<loop_state> loop;
+
+    public:
+        virtual ~loop_controller()
+        {
+        }
+        explicit loop_controller(std::shared_ptr<loop_state> l)
+            : loop(std::move(l))
+        {
+        }
+
+        virtual clock_type::time_point now() const {
+            return clock_type::now();
+        }
+
+        virtual void schedule(const schedulable& scbl) const {
+            schedule(now(), scbl);
+        }
+
+        virtual void schedule(clock_type::time_point when, const schedulable& scbl) const {
+            if (scbl.is_subscribed()) {
+                loop->push(when, scbl);
+            }
+        }
+    };
+
+    // binds each action to the lifetime of the worker, so the actions that
+    // are still queued are dropped when the worker is unsubscribed
+    struct loop_worker : public worker_interface
+    {
+    private:
+        typedef loop_worker this_type;
+        loop_worker(const this_type&);
+
+        composite_subscription lifetime;
+        worker controller;
+
+    public:
+        virtual ~loop_worker()
+        {
+        }
+        loop_worker(composite_subscription cs, worker w)
+            : lifetime(cs)
+            , controller(w)
+        {
+        }
+
+        virtual clock_type::time_point now() const {
+            return clock_type::now();
+        }
+
+        virtual void schedule(const schedulable& scbl) const {
+            controller.schedule(lifetime, scbl.get_action());
+        }
+
+        virtual void schedule(clock_type::time_point when, const schedulable& scbl) const {
+            controller.schedule(when, lifetime, scbl.get_action());
+        }
+    };
+
+    std::vector<std::shared_ptr<loop_state>> loops;
+
+    void create_loops(thread_factory& tf, size_t count, clock_type::duration idle_timeout, clock_type::duration spin, event_loop_counters counters) {
+        if (std::thread::hardware_concurrency() < 2) {
+            // with one cpu the action cannot be scheduled while the loop
+            // spins, spinning only delays the thread that schedules it
+            spin = clock_type::duration::zero();
+        }
+        for (size_t i = 0; i != std::max(count, size_t(1)); ++i) {
+            loops.push_back(std::make_shared<loop_state>(tf, idle_timeout, spin, counters));
+        }
+    }
+
+    static size_t default_thread_count() {
+        return std::max(std::thread::hardware_concurrency(), unsigned(4)) - 1;
+    }
+
+public:
+    elastic_event_loop()
+    {
+        thread_factory tf([](std::function<void()> start){
+            return std::thread(std::move(start));
+        });
+        create_loops(tf, default_thread_count(), std::chrono::seconds(2), std::chrono::microseconds(50), event_loop_counters());
+    }
+    elastic_event_loop(thread_factory tf, size_t max_threads, clock_type::duration idle_timeout,
+        clock_type::duration spin = std::chrono::microseconds(50), event_loop_counters counters = event_loop_counters())
+    {
+        create_loops(tf, max_threads, idle_timeout, spin, std::move(counters));
+    }
+    virtual ~elastic_event_loop()
+    {
+        for (auto& l : loops) {
+            l->stop();
+        }
+    }
+
+    virtual clock_type::time_point now() const {
+        return clock_type::now();
+    }
+
+    virtual worker create_worker(composite_subscription cs) const {
+        // the loop with the fewest workers, the first one on a tie, so that
+        // the loops that are not needed are not started
+        auto selected = loops.front();
+        size_t fewest = selected->workers;
+        for (auto& l : loops) {
+            size_t count = l->workers;
+            if (count < fewest) {
+                selected = l;
+                fewest = count;
+            }
+        }
+        ++selected->workers;
+        auto placed = selected;
+        cs.add([placed](){
+            --placed->workers;
+        });
+        auto loop_lifetime = selected->lifetime;
+        worker controller(std::move(loop_lifetime), std::make_shared<loop_controller>(std::move(selected)));
+        return worker(cs, std::make_shared<loop_worker>(cs, std::move(controller)));
+    }
+};
+
+inline void elastic_event_loop::loop_state::run() {
+    // actions scheduled on current_thread from this thread go to the loop
+    detail::action_queue::ensure(std::make_shared<loop_controller>(this->shared_from_this()));
+    RXCPP_UNWIND_AUTO([]{
+        detail::action_queue::destroy();
+    });
+
+    bool idle = false;
+    std::unique_lock<std::mutex> guard(lock);
+    auto idle_since = clock_type::now();
+    for (;;) {
+        if (stopping) {
+            break;
+        }
+        if (queue.empty()) {
+            guard.unlock();
+            bool found = spin_for_action();
+            guard.lock();
+            if (found) {
+                counters.spun();
+                continue;
+            }
+            if (stopping || !queue.empty()) {
+                continue;
+            }
+            auto retire_at = idle_since + idle_timeout;
+            if (clock_type::now() >= retire_at) {
+                idle = true;
+                break;
+            }
+            sleeping = true;
+            wake.wait_until(guard, retire_at);
+            sleeping = false;
+            continue;
+        }
+        auto& peek = queue.top();
+        if (!peek.what.is_subscribed()) {
+            queue.pop();
+            --queued;
+            continue;
+        }
+        if (clock_type::now() < peek.when) {
+            sleeping = true;
+            wake.wait_until(guard, peek.when);
+            sleeping = false;
+            continue;
+        }
+        auto what = peek.what;
+        queue.pop();
+        --queued;
+        r.reset(queue.empty());
+        guard.unlock();
+        what(r.get_recurse());
+        guard.lock();
+        idle_since = clock_type::now();
+    }
+    running = false;
+    guard.unlock();
+    counters.thread_exited(idle);
+
+    // a retired thread releases its resources on exit, unless a new thread
+    // or stop already took it
+    std::unique_lock<std::mutex> starting(start_lock);
+    if (thread.joinable() && thread.get_id() == std::this_thread::get_id()) {
+        thread.detach();
+    }
+}
+
+inline scheduler make_elastic_event_loop() {
+    static auto loop = make_scheduler<elastic_event_loop>();
+    return loop;
+}
+inline scheduler make_elastic_event_loop(thread_factory tf, size_t max_threads, scheduler::clock_type::duration idle_timeout) {
+    return make_scheduler<elastic_event_loop>(tf, max_threads, idle_timeout);
+}
+inline scheduler make_elastic_event_loop(thread_factory tf, size_t max_threads, scheduler::clock_type::duration idle_timeout,
+    scheduler::clock_type::duration spin, event_loop_counters counters) {
+    return make_scheduler<elastic_event_loop>(tf, max_threads, idle_timeout, spin, counters);
+}
+
+}
+
+}
+
+#endif
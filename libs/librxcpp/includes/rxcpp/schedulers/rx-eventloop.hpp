@@ -82,6 +82,29 @@ public:
             loops.push_back(newthread.create_worker());
         }
     }
+    /// the loop threads wait for actions with the selected strategy
+    event_loop(thread_factory tf, wait_kind::type wait)
+        : factory(tf)
+        , newthread(make_new_thread(tf, timer_kind::heap, wait))
+        , count(0)
+    {
+        auto remaining = std::max(std::thread::hardware_concurrency(), unsigned(4));
+        while (--remaining) {
+            loops.push_back(newthread.create_worker());
+        }
+    }
+    /// one loop for each of cpus, loop n runs on cpus[n] in a thread named
+    /// name-n. physical_cores() and numa_node_cpus() select the cpus.
+    event_loop(std::vector<unsigned> cpus, std::string name)
+        : factory(make_pinned_thread_factory(cpus, std::move(name)))
+        , newthread(make_new_thread(factory))
+        , count(0)
+    {
+        // the factory pins the threads in the order they are created
+        for (size_t i = 0; i != std::max(cpus.size(), size_t(1)); ++i) {
+            loops.push_back(newthread.create_worker());
+        }
+    }
     virtual ~event_loop()
     {
     }
@@ -102,6 +125,12 @@ inline scheduler make_event_loop() {
 inline scheduler make_event_loop(thread_factory tf) {
     return make_scheduler<event_loop>(tf);
 }
+inline scheduler make_event_loop(thread_factory tf, wait_kind::type wait) {
+    return make_scheduler<event_loop>(tf, wait);
+}
+inline scheduler make_event_loop(std::vector<unsigned> cpus, std::string name) {
+    return make_scheduler<event_loop>(std::move(cpus), std::move(name));
+}
 
 }
 
@@ -30,7 +30,7 @@ private:
 
         struct new_worker_state : public std::enable_shared_from_this<new_worker_state>
         {
-            typedef detail::schedulable_queue<
+            typedef detail::timed_queue<
                 typename clock_type::time_point> queue_item_time;
 
             typedef queue_item_time::item_type item_type;
@@ -49,8 +49,12 @@ private:
                 }
             }
 
-            explicit new_worker_state(composite_subscription cs)
+            new_worker_state(composite_subscription cs, timer_kind::type timers, wait_kind::type wait)
                 : lifetime(cs)
+                , queue(timers)
+                , wait(wait)
+                , sleeping(false)
+                , pushes(0)
             {
             }
 
@@ -60,6 +64,64 @@ private:
             mutable queue_item_time queue;
             std::thread worker;
             recursion r;
+            const wait_kind::type wait;
+            // true while the thread waits on wake
+            bool sleeping;
+            // counts the actions scheduled, read without the lock while
+            // the thread spins
+            std::atomic<size_t> pushes;
+
+            // must be called with lock held. returns with lock held when an
+            // action was scheduled, the lifetime ended or, when timed, when
+            // is reached.
+            void idle(std::unique_lock<std::mutex>& guard, bool timed, clock_type::time_point when) {
+                if (wait != wait_kind::blocking) {
+                    size_t seen = pushes;
+                    guard.unlock();
+                    bool woke = poll(seen, timed, when);
+                    guard.lock();
+                    if (woke) {
+                        return;
+                    }
+                }
+                sleeping = true;
+                if (timed) {
+                    wake.wait_until(guard, when);
+                } else {
+                    wake.wait(guard, [this](){
+                        return !lifetime.is_subscribed() || !queue.empty();
+                    });
+                }
+                sleeping = false;
+            }
+
+            // returns false when the thread should sleep
+            bool poll(size_t seen, bool timed, clock_type::time_point when) const {
+                // how long spin_park spins and then yields before it sleeps
+                static const auto spin_for = std::chrono::microseconds(5);
+                static const auto yield_for = std::chrono::microseconds(50);
+
+                auto start = clock_type::now();
+                for (auto now = start;; now = clock_type::now()) {
+                    if (timed && now >= when) {
+                        return true;
+                    }
+                    bool spinning = wait == wait_kind::busy_poll || now < start + spin_for;
+                    if (!spinning && now >= start + yield_for) {
+                        return false;
+                    }
+                    for (int i = 0; i != 64; ++i) {
+                        if (pushes != seen || !lifetime.is_subscribed()) {
+                            return true;
+                        }
+                        if (spinning) {
+                            rxu::detail::cpu_relax();
+                        } else {
+                            std::this_thread::yield();
+                        }
+                    }
+                }
+            }
         };
 
         std::shared_ptr<new_worker_state> state;
@@ -74,8 +136,8 @@ private:
         {
         }
 
-        new_worker(composite_subscription cs, thread_factory& tf)
-            : state(std::make_shared<new_worker_state>(cs))
+        new_worker(composite_subscription cs, thread_factory& tf, timer_kind::type timers, wait_kind::type wait)
+            : state(std::make_shared<new_worker_state>(cs, timers, wait))
         {
             auto keepAlive = state;
 
@@ -94,21 +156,20 @@ private:
 
                 for(;;) {
                     std::unique_lock<std::mutex> guard(keepAlive->lock);
-                    if (keepAlive->queue.empty()) {
-                        keepAlive->wake.wait(guard, [keepAlive](){
-                            return !keepAlive->lifetime.is_subscribed() || !keepAlive->queue.empty();
-                        });
-                    }
                     if (!keepAlive->lifetime.is_subscribed()) {
                         break;
                     }
+                    if (keepAlive->queue.empty()) {
+                        keepAlive->idle(guard, false, clock_type::time_point());
+                        continue;
+                    }
                     auto& peek = keepAlive->queue.top();
                     if (!peek.what.is_subscribed()) {
                         keepAlive->queue.pop();
                         continue;
                     }
                     if (clock_type::now() < peek.when) {
-                        keepAlive->wake.wait_until(guard, peek.when);
+                        keepAlive->idle(guard, true, peek.when);
                         continue;
                     }
                     auto what = peek.what;
@@ -129,26 +190,40 @@ private:
         }
 
         virtual void schedule(clock_type::time_point when, const schedulable& scbl) const {
-            if (scbl.is_subscribed()) {
-                std::unique_lock<std::mutex> guard(state->lock);
-                state->queue.push(new_worker_state::item_type(when, scbl));
-                state->r.reset(false);
+            if (!scbl.is_subscribed()) {
+                return;
+            }
+            std::unique_lock<std::mutex> guard(state->lock);
+            state->queue.push(new_worker_state::item_type(when, scbl));
+            state->r.reset(false);
+            ++state->pushes;
+            if (state->sleeping) {
+                // a running or polling thread does not need a notify
+                guard.unlock();
+                state->wake.notify_one();
             }
-            state->wake.notify_one();
         }
     };
 
     mutable thread_factory factory;
+    timer_kind::type timers;
+    wait_kind::type wait;
 
 public:
     new_thread()
         : factory([](std::function<void()> start){
             return std::thread(std::move(start));
         })
+        , timers(timer_kind::heap)
+        , wait(wait_kind::blocking)
     {
     }
-    explicit new_thread(thread_factory tf)
+    explicit new_thread(thread_factory tf, timer_kind::type timers = timer_kind::heap, wait_kind::type wait = wait_kind::blocking)
         : factory(tf)
+        , timers(timers)
+        // with one cpu the thread that schedules the action cannot run
+        // while the worker polls, so the worker sleeps instead
+        , wait(wait == wait_kind::blocking || std::thread::hardware_concurrency() < 2 ? wait_kind::blocking : wait)
     {
     }
     virtual ~new_thread()
@@ -160,7 +235,7 @@ public:
     }
 
     virtual worker create_worker(composite_subscription cs) const {
-        return worker(cs, std::shared_ptr<new_worker>(new new_worker(cs, factory)));
+        return worker(cs, std::shared_ptr<new_worker>(new new_worker(cs, factory, timers, wait)));
     }
 };
 
@@ -171,6 +246,17 @@ inline scheduler make_new_thread() {
 inline scheduler make_new_thread(thread_factory tf) {
     return make_scheduler<new_thread>(tf);
 }
+/// each worker keeps its timed actions in the selected structure.
+/// timer_kind::wheel suits workers with many short lived timers.
+inline scheduler make_new_thread(thread_factory tf, timer_kind::type timers) {
+    return make_scheduler<new_thread>(tf, timers);
+}
+/// each worker thread waits for the next action with the selected strategy.
+/// wait_kind::spin_park trades some cpu for a lower latency to a thread
+/// that went idle recently.
+inline scheduler make_new_thread(thread_factory tf, timer_kind::type timers, wait_kind::type wait) {
+    return make_scheduler<new_thread>(tf, timers, wait);
+}
 
 }
 
@@ -0,0 +1,313 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved. See License.txt in the project root for license information.
+
+#pragma once
+
+#if !defined(RXCPP_RX_SCHEDULER_POOLED_THREAD_HPP)
+#define RXCPP_RX_SCHEDULER_POOLED_THREAD_HPP
+
+#include "../rx-includes.hpp"
+
+namespace rxcpp {
+
+namespace schedulers {
+
+/// pooled_thread gives each worker a thread of its own, like new_thread.
+/// when the lifetime of a worker ends its thread is parked and the next
+/// worker runs on it, instead of creating a thread for every worker.
+/// at most max_idle threads are parked, the others exit.
+struct pooled_thread : public scheduler_interface
+{
+private:
+    typedef pooled_thread this_type;
+    pooled_thread(const this_type&);
+
+    struct pooled_worker_state
+    {
+        typedef detail::timed_queue<
+            typename clock_type::time_point> queue_item_time;
+
+        typedef queue_item_time::item_type item_type;
+
+        ~pooled_worker_state()
+        {
+            lifetime.unsubscribe();
+        }
+
+        pooled_worker_state(composite_subscription cs, timer_kind::type timers)
+            : lifetime(cs)
+            , queue(timers)
+        {
+        }
+
+        composite_subscription lifetime;
+        mutable std::mutex lock;
+        mutable std::condition_variable wake;
+        mutable queue_item_time queue;
+        recursion r;
+
+        // runs the actions on the calling thread until the lifetime ends
+        void run() {
+            for(;;) {
+                std::unique_lock<std::mutex> guard(lock);
+                if (queue.empty()) {
+                    wake.wait(guard, [this](){
+                        return !lifetime.is_subscribed() || !queue.empty();
+                    });
+                }
+                if (!lifetime.is_subscribed()) {
+                    // release the actions and what they hold before the
+                    // thread is reused
+                    while (!queue.empty()) {
+                        queue.pop();
+                    }
+                    break;
+                }
+                auto& peek = queue.top();
+                if (!peek.what.is_subscribed()) {
+                    queue.pop();
+                    continue;
+                }
+                if (clock_type::now() < peek.when) {
+                    wake.wait_until(guard, peek.when);
+                    continue;
+                }
+                auto what = peek.what;
+                queue.pop();
+                r.reset(queue.empty());
+                guard.unlock();
+                what(r.get_recurse());
+            }
+        }
+    };
+
+    struct pooled_worker : public worker_interface
+    {
+    private:
+        typedef pooled_worker this_type;
+        pooled_worker(const this_type&);
+
+        std::shared_ptr<pooled_worker_state> state;
+
+    public:
+        virtual ~pooled_worker()
+        {
+        }
+
+        explicit pooled_worker(std::shared_ptr<pooled_worker_state> ws)
+            : state(std::move(ws))
+        {
+        }
+
+        virtual clock_type::time_point now() const {
+            return clock_type::now();
+        }
+
+        virtual void schedule(const schedulable& scbl) const {
+            schedule(now(), scbl);
+        }
+
+        virtual void schedule(clock_type::time_point when, const schedulable& scbl) const {
+            if (scbl.is_subscribed()) {
+                std::unique_lock<std::mutex> guard(state->lock);
+                state->queue.push(pooled_worker_state::item_type(when, scbl));
+                state->r.reset(false);
+            }
+            state->wake.notify_one();
+        }
+    };
+
+    // a thread of the pool, it runs one worker at a time
+    struct pool_thread
+    {
+        pool_thread()
+            : exited(false)
+        {
+        }
+        std::thread thread;
+        // the next worker to run, set by the pool
+        std::shared_ptr<pooled_worker_state> assigned;
+        std::condition_variable wake;
+        // set when the thread exits before it was stored
+        bool exited;
+    };
+    typedef std::shared_ptr<pool_thread> thread_ptr;
+
+    struct pool_state : public std::enable_shared_from_this<pool_state>
+    {
+        pool_state(thread_factory tf, size_t max_idle)
+            : factory(std::move(tf))
+            , max_idle(max_idle)
+            , stopping(false)
+        {
+        }
+
+        thread_factory factory;
+        size_t max_idle;
+
+        // guards the threads and their assignments
+        std::mutex lock;
+        std::vector<thread_ptr> threads;
+        std::vector<thread_ptr> idle;
+        bool stopping;
+
+        void assign(std::shared_ptr<pooled_worker_state> ws) {
+            std::unique_lock<std::mutex> guard(lock);
+            if (!idle.empty()) {
+                auto t = std::move(idle.back());
+                idle.pop_back();
+                t->assigned = std::move(ws);
+                t->wake.notify_one();
+                return;
+            }
+            auto t = std::make_shared<pool_thread>();
+            t->assigned = std::move(ws);
+            threads.push_back(t);
+            guard.unlock();
+
+            // threads are created outside the lock
+            auto keepAlive = this->shared_from_this();
+            auto created = factory([keepAlive, t](){
+                keepAlive->loop(t);
+            });
+
+            guard.lock();
+            if (t->exited || stopping) {
+                created.detach();
+            } else {
+                t->thread = std::move(created);
+            }
+        }
+
+        void loop(const thread_ptr& self) {
+            for (;;) {
+                std::shared_ptr<pooled_worker_state> ws;
+                {
+                    std::unique_lock<std::mutex> guard(lock);
+                    self->wake.wait(guard, [&](){
+                        return !!self->assigned || stopping;
+                    });
+                    if (!self->assigned) {
+                        break;
+                    }
+                    ws = std::move(self->assigned);
+                }
+
+                {
+                    // the worker owns the current_thread queue of the thread
+                    // while it runs
+                    detail::action_queue::ensure(std::make_shared<pooled_worker>(ws));
+                    RXCPP_UNWIND_AUTO([]{
+                        detail::action_queue::destroy();
+                    });
+                    ws->run();
+                }
+                ws.reset();
+
+                std::unique_lock<std::mutex> guard(lock);
+                if (stopping || idle.size() >= max_idle) {
+                    break;
+                }
+                idle.push_back(self);
+            }
+
+            std::unique_lock<std::mutex> guard(lock);
+            if (stopping) {
+                // stop joins or detaches the thread
+                return;
+            }
+            threads.erase(std::find(threads.begin(), threads.end(), self));
+            if (self->thread.joinable()) {
+                self->thread.detach();
+            } else {
+                self->exited = true;
+            }
+        }
+
+        void stop() {
+            std::vector<thread_ptr> parked;
+            {
+                std::unique_lock<std::mutex> guard(lock);
+                stopping = true;
+                parked.swap(idle);
+                for (auto& t : threads) {
+                    if (std::find(parked.begin(), parked.end(), t) != parked.end()) {
+                        t->wake.notify_one();
+                    } else if (t->thread.joinable()) {
+                        // the thread exits when its worker ends
+                        t->thread.detach();
+                    }
+                }
+                threads.clear();
+            }
+            for (auto& t : parked) {
+                if (t->thread.joinable()) {
+                    if (t->thread.get_id() == std::this_thread::get_id()) {
+                        t->thread.detach();
+                    } else {
+                        t->thread.join();
+                    }
+                }
+            }
+        }
+    };
+
+    std::shared_ptr<pool_state> pool;
+    timer_kind::type timers;
+
+    static size_t default_max_idle() {
+        return std::max(std::thread::hardware_concurrency(), unsigned(4));
+    }
+
+public:
+    pooled_thread()
+        : pool(std::make_shared<pool_state>(
+            thread_factory([](std::function<void()> start){
+                return std::thread(std::move(start));
+            }),
+            default_max_idle()))
+        , timers(timer_kind::heap)
+    {
+    }
+    pooled_thread(thread_factory tf, size_t max_idle, timer_kind::type timers = timer_kind::heap)
+        : pool(std::make_shared<pool_state>(std::move(tf), max_idle))
+        , timers(timers)
+    {
+    }
+    virtual ~pooled_thread()
+    {
+        pool->stop();
+    }
+
+    virtual clock_type::time_point now() const {
+        return clock_type::now();
+    }
+
+    virtual worker create_worker(composite_subscription cs) const {
+        auto ws = std::make_shared<pooled_worker_state>(cs, timers);
+        auto keepAlive = ws;
+        ws->lifetime.add([keepAlive](){
+            // a thread that missed this would never return to the pool
+            std::unique_lock<std::mutex> guard(keepAlive->lock);
+            keepAlive->wake.notify_one();
+        });
+        pool->assign(ws);
+        return worker(cs, std::make_shared<pooled_worker>(std::move(ws)));
+    }
+};
+
+inline scheduler make_pooled_thread() {
+    static auto pt = make_scheduler<pooled_thread>();
+    return pt;
+}
+inline scheduler make_pooled_thread(thread_factory tf, size_t max_idle) {
+    return make_scheduler<pooled_thread>(tf, max_idle);
+}
+inline scheduler make_pooled_thread(thread_factory tf, size_t max_idle, timer_kind::type timers) {
+    return make_scheduler<pooled_thread>(tf, max_idle, timers);
+}
+
+}
+
+}
+
+#endif
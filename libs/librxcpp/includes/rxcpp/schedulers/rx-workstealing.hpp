@@ -0,0 +1,415 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved. See License.txt in the project root for license information.
+
+#pragma once
+
+#if !defined(RXCPP_RX_SCHEDULER_WORK_STEALING_HPP)
+#define RXCPP_RX_SCHEDULER_WORK_STEALING_HPP
+
+#include "../rx-includes.hpp"
+
+namespace rxcpp {
+
+namespace schedulers {
+
+/// work_stealing runs all workers on a fixed set of threads.
+/// each worker is a strand that runs on at most one thread at a time, so
+/// the actions scheduled on a worker still run in order with no overlap.
+/// a strand with due actions is queued on the deque of the thread that
+/// scheduled it. threads that run out of strands steal from the other deques.
+struct work_stealing : public scheduler_interface
+{
+private:
+    typedef work_stealing this_type;
+    work_stealing(const this_type&);
+
+    struct pool_state;
+
+    struct strand : public worker_interface
+    {
+    private:
+        typedef strand this_type;
+        strand(const this_type&);
+
+        typedef detail::schedulable_queue<
+            typename clock_type::time_point> queue_item_time;
+
+        typedef queue_item_time::item_type item_type;
+
+        std::shared_ptr<const strand> get_strand() const {
+            return std::static_pointer_cast<const strand>(shared_from_this());
+        }
+
+    public:
+        // the number of actions a strand may run before it is requeued
+        // behind the other ready strands.
+        static const int budget = 64;
+
+        strand(std::shared_ptr<pool_state> p, composite_subscription cs)
+            : pool(std::move(p))
+            , lifetime(std::move(cs))
+            , scheduled(false)
+            , armed(false)
+        {
+        }
+        virtual ~strand()
+        {
+        }
+
+        std::shared_ptr<pool_state> pool;
+        composite_subscription lifetime;
+        mutable std::mutex lock;
+        mutable queue_item_time queue;
+        // true while the strand is in a ready deque or running
+        mutable bool scheduled;
+        // true while the strand has an entry in the pool timers
+        mutable bool armed;
+        mutable clock_type::time_point armed_at;
+        recursion r;
+
+        virtual clock_type::time_point now() const {
+            return clock_type::now();
+        }
+
+        virtual void schedule(const schedulable& scbl) const {
+            schedule(now(), scbl);
+        }
+
+        virtual void schedule(clock_type::time_point when, const schedulable& scbl) const {
+            if (!scbl.is_subscribed()) {
+                return;
+            }
+            std::unique_lock<std::mutex> guard(lock);
+            queue.push(item_type(when, scbl));
+            r.reset(false);
+            ready(guard);
+        }
+
+        // must be called with lock held. the lock is released when the
+        // strand is submitted or a timer is added.
+        void ready(std::unique_lock<std::mutex>& guard) const {
+            if (scheduled || queue.empty()) {
+                return;
+            }
+            auto when = queue.top().when;
+            if (when <= clock_type::now()) {
+                scheduled = true;
+                guard.unlock();
+                pool->submit(get_strand());
+            } else if (!armed || when < armed_at) {
+                armed = true;
+                armed_at = when;
+                guard.unlock();
+                pool->add_timer(when, get_strand());
+            }
+        }
+
+        // called by the pool when a timer for this strand expires
+        void wake() const {
+            std::unique_lock<std::mutex> guard(lock);
+            armed = false;
+            ready(guard);
+        }
+
+        // called by a pool thread to run the due actions
+        void run() const {
+            std::unique_lock<std::mutex> guard(lock);
+            for (int count = 0;; ++count) {
+                if (!lifetime.is_subscribed() || queue.empty()) {
+                    scheduled = false;
+                    return;
+                }
+                auto& peek = queue.top();
+                if (!peek.what.is_subscribed()) {
+                    queue.pop();
+                    continue;
+                }
+                if (clock_type::now() < peek.when) {
+                    scheduled = false;
+                    ready(guard);
+                    return;
+                }
+                if (count == budget) {
+                    // stay scheduled and let other strands run
+                    guard.unlock();
+                    pool->submit(get_strand());
+                    return;
+                }
+                auto what = peek.what;
+                queue.pop();
+                r.reset(queue.empty());
+                guard.unlock();
+                what(r.get_recurse());
+                guard.lock();
+            }
+        }
+    };
+
+    typedef std::shared_ptr<const strand> strand_ptr;
+
+    // each pool thread owns a deque of ready strands. the owner pushes and
+    // pops at the back and idle threads steal from the front.
+    struct ready_queue
+    {
+        std::mutex lock;
+        std::deque<strand_ptr> strands;
+    };
+
+    struct timer_type
+    {
+        timer_type(clock_type::time_point when, std::weak_ptr<const strand> what)
+            : when(when)
+            , what(std::move(what))
+        {
+        }
+        clock_type::time_point when;
+        std::weak_ptr<const strand> what;
+    };
+    struct compare_timer
+    {
+        bool operator()(const timer_type& lhs, const timer_type& rhs) const {
+            return lhs.when > rhs.when;
+        }
+    };
+    typedef std::priority_queue<timer_type, std::vector<timer_type>, compare_timer> timer_queue;
+
+    struct pool_state : public std::enable_shared_from_this<pool_state>
+    {
+        explicit pool_state(size_t count)
+            : ready(0)
+            , sleeping(0)
+            , next(0)
+            , stopping(false)
+            , next_timer(never())
+        {
+            for (size_t i = 0; i != count; ++i) {
+                queues.push_back(std::unique_ptr<ready_queue>(new ready_queue()));
+            }
+        }
+
+        std::vector<std::unique_ptr<ready_queue>> queues;
+        std::vector<std::thread> threads;
+        std::atomic<size_t> ready;
+        std::atomic<int> sleeping;
+        std::atomic<size_t> next;
+        std::atomic<bool> stopping;
+
+        // guards timers and the sleeping threads
+        std::mutex lock;
+        std::condition_variable wake;
+        timer_queue timers;
+        // the time of the earliest timer, read without the lock
+        std::atomic<clock_type::rep> next_timer;
+
+        static clock_type::rep never() {
+            return clock_type::time_point::max().time_since_epoch().count();
+        }
+
+        static const pool_state*& current_pool() {
+            static RXCPP_THREAD_LOCAL const pool_state* pool;
+            return pool;
+        }
+        static size_t& current_index() {
+            static RXCPP_THREAD_LOCAL size_t index;
+            return index;
+        }
+
+        void submit(strand_ptr s) {
+            size_t index = current_pool() == this ? current_index() : (next++ % queues.size());
+            {
+                std::unique_lock<std::mutex> guard(queues[index]->lock);
+                queues[index]->strands.push_back(std::move(s));
+            }
+            ++ready;
+            if (sleeping > 0) {
+                std::unique_lock<std::mutex> guard(lock);
+                wake.notify_one();
+            }
+        }
+
+        void add_timer(clock_type::time_point when, strand_ptr s) {
+            std::unique_lock<std::mutex> guard(lock);
+            bool earliest = timers.empty() || when < timers.top().when;
+            timers.push(timer_type(when, s));
+            if (earliest) {
+                next_timer = when.time_since_epoch().count();
+                wake.notify_one();
+            }
+        }
+
+        // must be called with lock held. moves the strands with due timers
+        // to expired
+        void expire(clock_type::time_point now, std::vector<strand_ptr>& expired) {
+            while (!timers.empty() && timers.top().when <= now) {
+                auto due = timers.top().what.lock();
+                timers.pop();
+                if (due) {
+                    expired.push_back(std::move(due));
+                }
+            }
+            next_timer = timers.empty() ? never() : timers.top().when.time_since_epoch().count();
+        }
+
+        void wake_expired(std::vector<strand_ptr>& expired) {
+            for (auto& e : expired) {
+                e->wake();
+            }
+            expired.clear();
+        }
+
+        strand_ptr take(size_t index) {
+            // own deque first, newest strand is the most likely to be cache hot
+            {
+                auto& own = *queues[index];
+                std::unique_lock<std::mutex> guard(own.lock);
+                if (!own.strands.empty()) {
+                    auto s = std::move(own.strands.back());
+                    own.strands.pop_back();
+                    --ready;
+                    return s;
+                }
+            }
+            // steal the oldest strand from another thread
+            for (size_t offset = 1; offset < queues.size(); ++offset) {
+                auto& other = *queues[(index + offset) % queues.size()];
+                std::unique_lock<std::mutex> guard(other.lock);
+                if (!other.strands.empty()) {
+                    auto s = std::move(other.strands.front());
+                    other.strands.pop_front();
+                    --ready;
+                    return s;
+                }
+            }
+            return strand_ptr();
+        }
+
+        void loop(size_t index) {
+            current_pool() = this;
+            current_index() = index;
+
+            std::vector<strand_ptr> expired;
+            for (;;) {
+                if (stopping) {
+                    break;
+                }
+                // due timers are checked before each strand. busy strands
+                // requeue themselves, so take() may never come back empty
+                auto now = clock_type::now();
+                if (next_timer <= now.time_since_epoch().count()) {
+                    {
+                        std::unique_lock<std::mutex> guard(lock);
+                        expire(now, expired);
+                    }
+                    wake_expired(expired);
+                }
+                auto s = take(index);
+                if (s) {
+                    s->run();
+                    continue;
+                }
+
+                std::unique_lock<std::mutex> guard(lock);
+                if (stopping) {
+                    break;
+                }
+                expire(clock_type::now(), expired);
+                if (!expired.empty()) {
+                    guard.unlock();
+                    wake_expired(expired);
+                    continue;
+                }
+                ++sleeping;
+                if (ready == 0) {
+                    if (timers.empty()) {
+                        wake.wait(guard);
+                    } else {
+                        wake.wait_until(guard, timers.top().when);
+                    }
+                }
+                --sleeping;
+            }
+
+            current_pool() = nullptr;
+        }
+
+        void stop() {
+            {
+                std::unique_lock<std::mutex> guard(lock);
+                stopping = true;
+                wake.notify_all();
+            }
+            for (auto& t : threads) {
+                if (t.joinable()) {
+                    if (t.get_id() == std::this_thread::get_id()) {
+                        t.detach();
+                    } else {
+                        t.join();
+                    }
+                }
+            }
+            // release the strands, they hold the pool
+            for (auto& q : queues) {
+                std::unique_lock<std::mutex> guard(q->lock);
+                q->strands.clear();
+            }
+            std::unique_lock<std::mutex> guard(lock);
+            timers = timer_queue();
+            next_timer = never();
+        }
+    };
+
+    std::shared_ptr<pool_state> pool;
+
+    void start(thread_factory& tf) {
+        for (size_t i = 0; i != pool->queues.size(); ++i) {
+            auto keepAlive = pool;
+            pool->threads.push_back(tf([keepAlive, i](){
+                keepAlive->loop(i);
+            }));
+        }
+    }
+
+    static size_t default_thread_count() {
+        return std::max(std::thread::hardware_concurrency(), unsigned(2));
+    }
+
+public:
+    work_stealing()
+        : pool(std::make_shared<pool_state>(default_thread_count()))
+    {
+        thread_factory tf([](std::function<void()> start){
+            return std::thread(std::move(start));
+        });
+        start(tf);
+    }
+    explicit work_stealing(thread_factory tf, size_t count = default_thread_count())
+        : pool(std::make_shared<pool_state>(std::max(count, size_t(1))))
+    {
+        start(tf);
+    }
+    virtual ~work_stealing()
+    {
+        pool->stop();
+    }
+
+    virtual clock_type::time_point now() const {
+        return clock_type::now();
+    }
+
+    virtual worker create_worker(composite_subscription cs) const {
+        return worker(cs, std::make_shared<strand>(pool, cs));
+    }
+};
+
+inline scheduler make_work_stealing() {
+    static auto ws = make_scheduler<work_stealing>();
+    return ws;
+}
+inline scheduler make_work_stealing(thread_factory tf, size_t count) {
+    return make_scheduler<work_stealing>(tf, count);
+}
+
+}
+
+}
+
+#endif
@@ -49,18 +49,20 @@ struct iterate : public source_base<typename iterate_traits<Collection>::value_t
 
     struct iterate_initial_type
     {
-        iterate_initial_type(collection_type c, coordination_type cn)
+        iterate_initial_type(collection_type c, coordination_type cn, std::size_t b)
             : collection(std::move(c))
             , coordination(std::move(cn))
+            , batch(std::max<std::size_t>(b, 1))
         {
         }
         collection_type collection;
         coordination_type coordination;
+        std::size_t batch;
     };
     iterate_initial_type initial;
 
-    iterate(collection_type c, coordination_type cn)
-        : initial(std::move(c), std::move(cn))
+    iterate(collection_type c, coordination_type cn, std::size_t batch = 1)
+        : initial(std::move(c), std::move(cn), batch)
     {
     }
     template<class Subscriber>
@@ -99,21 +101,24 @@ struct iterate : public source_base<typename iterate_traits<Collection>::value_t
         auto controller = coordinator.get_worker();
 
         auto producer = [state](const rxsc::schedulable& self){
-            if (!state.out.is_subscribed()) {
-                // terminate loop
-                return;
-            }
-
-            if (state.cursor != state.end) {
-                // send next value
-                state.out.on_next(*state.cursor);
-                ++state.cursor;
-            }
-
-            if (state.cursor == state.end) {
-                state.out.on_completed();
-                // o is unsubscribed
-                return;
+            // send up to batch values from each scheduled action
+            for (std::size_t count = 0; count != state.batch; ++count) {
+                if (!state.out.is_subscribed()) {
+                    // terminate loop
+                    return;
+                }
+
+                if (state.cursor != state.end) {
+                    // send next value
+                    state.out.on_next(*state.cursor);
+                    ++state.cursor;
+                }
+
+                if (state.cursor == state.end) {
+                    state.out.on_completed();
+                    // o is unsubscribed
+                    return;
+                }
             }
 
             // tail recurse this same action to continue loop
@@ -144,6 +149,13 @@ auto iterate(Collection c, Coordination cn)
     return  observable<typename detail::iterate_traits<Collection>::value_type, detail::iterate<Collection, Coordination>>(
                                                                                 detail::iterate<Collection, Coordination>(std::move(c), std::move(cn)));
 }
+/// emits up to batch values from each action scheduled on the coordination
+template<class Collection, class Coordination>
+auto iterate(Collection c, Coordination cn, std::size_t batch)
+    ->      observable<typename detail::iterate_traits<Collection>::value_type, detail::iterate<Collection, Coordination>> {
+    return  observable<typename detail::iterate_traits<Collection>::value_type, detail::iterate<Collection, Coordination>>(
+                                                                                detail::iterate<Collection, Coordination>(std::move(c), std::move(cn), batch));
+}
 
 template<class T>
 auto from()
@@ -21,21 +21,23 @@ struct range : public source_base<T>
 
     struct range_state_type
     {
-        range_state_type(T f, T l, ptrdiff_t s, coordination_type cn)
+        range_state_type(T f, T l, ptrdiff_t s, coordination_type cn, std::size_t b)
             : next(f)
             , last(l)
             , step(s)
             , coordination(std::move(cn))
+            , batch(std::max<std::size_t>(b, 1))
         {
         }
         mutable T next;
         T last;
         ptrdiff_t step;
         coordination_type coordination;
+        std::size_t batch;
     };
     range_state_type initial;
-    range(T f, T l, ptrdiff_t s, coordination_type cn)
-        : initial(f, l, s, std::move(cn))
+    range(T f, T l, ptrdiff_t s, coordination_type cn, std::size_t batch = 1)
+        : initial(f, l, s, std::move(cn), batch)
     {
     }
     template<class Subscriber>
@@ -53,27 +55,30 @@ struct range : public source_base<T>
 
         auto producer = [=](const rxsc::schedulable& self){
                 auto& dest = o;
-                if (!dest.is_subscribed()) {
-                    // terminate loop
-                    return;
-                }
+                // send up to batch values from each scheduled action
+                for (std::size_t count = 0; count != state.batch; ++count) {
+                    if (!dest.is_subscribed()) {
+                        // terminate loop
+                        return;
+                    }
 
-                // send next value
-                dest.on_next(state.next);
-                if (!dest.is_subscribed()) {
-                    // terminate loop
-                    return;
-                }
+                    // send next value
+                    dest.on_next(state.next);
+                    if (!dest.is_subscribed()) {
+                        // terminate loop
+                        return;
+                    }
 
-                if (std::abs(state.last - state.next) < std::abs(state.step)) {
-                    if (state.last != state.next) {
-                        dest.on_next(state.last);
+                    if (std::abs(state.last - state.next) < std::abs(state.step)) {
+                        if (state.last != state.next) {
+                            dest.on_next(state.last);
+                        }
+                        dest.on_completed();
+                        // o is unsubscribed
+                        return;
                     }
-                    dest.on_completed();
-                    // o is unsubscribed
-                    return;
+                    state.next = static_cast<T>(state.step + state.next);
                 }
-                state.next = static_cast<T>(state.step + state.next);
 
                 // tail recurse this same action to continue loop
                 self();
@@ -104,6 +109,13 @@ auto range(T first, T last, ptrdiff_t step, Coordination cn)
     return  observable<T,   detail::range<T, Coordination>>(
                             detail::range<T, Coordination>(first, last, step, std::move(cn)));
 }
+/// emits up to batch values from each action scheduled on the coordination
+template<class T, class Coordination>
+auto range(T first, T last, ptrdiff_t step, Coordination cn, std::size_t batch)
+    ->      observable<T,   detail::range<T, Coordination>> {
+    return  observable<T,   detail::range<T, Coordination>>(
+                            detail::range<T, Coordination>(first, last, step, std::move(cn), batch));
+}
 template<class T, class Coordination>
 auto range(T first, T last, Coordination cn)
     -> typename std::enable_if<is_coordination<Coordination>::value,
@@ -19,7 +19,6 @@ class multicast_observer
 {
     typedef observer_base<T> base;
     typedef subscriber<T> observer_type;
-    typedef std::vector<observer_type> list_type;
 
     struct mode
     {
@@ -31,101 +30,214 @@ class multicast_observer
         };
     };
 
+    // observers are stored in fixed size segments that are appended but
+    // never moved or freed while the subject is alive. add and remove
+    // only touch one slot, so subscribing does not copy the other observers.
+    // on_next walks the segments without taking the lock.
+    static const size_t segment_size = 32;
+
+    typedef std::atomic<observer_type*> slot_type;
+
+    struct segment
+    {
+        segment()
+            : next(nullptr)
+        {
+            for (auto& slot : slots) {
+                slot = nullptr;
+            }
+        }
+        std::array<slot_type, segment_size> slots;
+        std::atomic<segment*> next;
+    };
+
     struct state_type
         : public std::enable_shared_from_this<state_type>
     {
         explicit state_type(composite_subscription cs)
-            : generation(0)
+            : readers(0)
+            , pending(0)
+            , used(0)
+            , count(0)
+            , id(trace_id::make_next_id_subscriber())
             , current(mode::Casting)
             , lifetime(cs)
+            , tail(&head)
         {
         }
-        std::atomic<int> generation;
-        std::mutex lock;
-        typename mode::type current;
-        std::exception_ptr error;
-        composite_subscription lifetime;
-    };
-
-    struct completer_type
-        : public std::enable_shared_from_this<completer_type>
-    {
-        ~completer_type()
+        ~state_type()
         {
+            for (auto s = &head; s != nullptr;) {
+                for (auto& slot : s->slots) {
+                    delete slot.load();
+                }
+                auto next = s->next.load();
+                if (s != &head) {
+                    delete s;
+                }
+                s = next;
+            }
+            for (auto o : retired) {
+                delete o;
+            }
         }
-        completer_type(std::shared_ptr<state_type> s, const std::shared_ptr<completer_type>& old, observer_type o)
-            : state(s)
-        {
-            if (old) {
-                observers.reserve(old->observers.size() + 1);
-                std::copy_if(
-                    old->observers.begin(), old->observers.end(),
-                    std::inserter(observers, observers.end()),
-                    [](const observer_type& o){
-                        return o.is_subscribed();
-                    });
+
+        // must only be called under lock
+        slot_type* insert(observer_type* o) {
+            if (!free.empty()) {
+                auto slot = free.back();
+                free.pop_back();
+                slot->store(o);
+                ++count;
+                return slot;
             }
-            observers.push_back(o);
+            auto index = used % segment_size;
+            if (index == 0 && used != 0) {
+                auto next = new segment();
+                tail->next = next;
+                tail = next;
+            }
+            auto slot = &tail->slots[index];
+            slot->store(o);
+            // publish the slot to on_next after it is filled
+            ++used;
+            ++count;
+            return slot;
         }
-        std::shared_ptr<state_type> state;
-        list_type observers;
-    };
 
-    // this type prevents a circular ref between state and completer
-    struct binder_type
-        : public std::enable_shared_from_this<binder_type>
-    {
-        explicit binder_type(composite_subscription cs)
-            : state(std::make_shared<state_type>(cs))
-            , id(trace_id::make_next_id_subscriber())
-            , current_generation(0)
-        {
+        // must only be called under lock
+        void retire(observer_type* o) {
+            retired.push_back(o);
+            ++pending;
+            reclaim();
+        }
+
+        // must only be called under lock
+        void reclaim() {
+            // an observer is only freed when no on_next is walking the
+            // segments. readers that start after the slot was cleared
+            // cannot see the retired observer.
+            if (readers == 0) {
+                for (auto r : retired) {
+                    delete r;
+                }
+                retired.clear();
+                pending = 0;
+            }
         }
 
-        std::shared_ptr<state_type> state;
+        void remove(slot_type* slot, observer_type* o) {
+            std::unique_lock<std::mutex> guard(lock);
+            if (slot->compare_exchange_strong(o, nullptr)) {
+                --count;
+                free.push_back(slot);
+                retire(o);
+            }
+        }
 
+        std::atomic<int> readers;
+        std::atomic<size_t> pending;
+        std::atomic<size_t> used;
+        std::atomic<size_t> count;
         trace_id id;
+        std::mutex lock;
+        typename mode::type current;
+        std::exception_ptr error;
+        composite_subscription lifetime;
+        segment head;
 
-        // used to avoid taking lock in on_next
-        mutable int current_generation;
-        mutable std::shared_ptr<completer_type> current_completer;
-
-        // must only be accessed under state->lock
-        mutable std::shared_ptr<completer_type> completer;
+        // must only be accessed under lock
+        segment* tail;
+        std::vector<slot_type*> free;
+        std::vector<observer_type*> retired;
     };
 
-    std::shared_ptr<binder_type> b;
+    std::shared_ptr<state_type> state;
+
+    template<class F>
+    void for_each_observer(F f) const {
+        ++state->readers;
+        RXCPP_UNWIND_AUTO([&](){
+            // the last reader out frees any observers removed while it was
+            // walking, unless a writer holds the lock and will do it.
+            if (--state->readers == 0 && state->pending != 0) {
+                std::unique_lock<std::mutex> guard(state->lock, std::try_to_lock);
+                if (guard.owns_lock()) {
+                    state->reclaim();
+                }
+            }
+        });
+        auto s = &state->head;
+        auto used = state->used.load();
+        for (size_t i = 0; i < used; ++i) {
+            if (i != 0 && i % segment_size == 0) {
+                s = s->next.load();
+            }
+            auto o = s->slots[i % segment_size].load();
+            if (o && o->is_subscribed()) {
+                f(*o);
+            }
+        }
+    }
+
+    // must only be called under lock
+    std::vector<observer_type> take_observers() const {
+        std::vector<observer_type> observers;
+        observers.reserve(state->count);
+        auto s = &state->head;
+        auto used = state->used.load();
+        for (size_t i = 0; i < used; ++i) {
+            if (i != 0 && i % segment_size == 0) {
+                s = s->next.load();
+            }
+            auto o = s->slots[i % segment_size].exchange(nullptr);
+            if (o) {
+                observers.push_back(*o);
+                state->retire(o);
+            }
+        }
+        state->count = 0;
+        return observers;
+    }
 
 public:
     typedef subscriber<T, observer<T, detail::multicast_observer<T>>> input_subscriber_type;
 
     explicit multicast_observer(composite_subscription cs)
-        : b(std::make_shared<binder_type>(cs))
+        : state(std::make_shared<state_type>(cs))
     {
     }
     trace_id get_id() const {
-        return b->id;
+        return state->id;
     }
     composite_subscription get_subscription() const {
-        return b->state->lifetime;
+        return state->lifetime;
     }
     input_subscriber_type get_subscriber() const {
         return make_subscriber<T>(get_id(), get_subscription(), observer<T, detail::multicast_observer<T>>(*this));
     }
     bool has_observers() const {
-        std::unique_lock<std::mutex> guard(b->state->lock);
-        return b->current_completer && !b->current_completer->observers.empty();
+        return state->count != 0;
     }
     template<class SubscriberFrom>
     void add(const SubscriberFrom& sf, observer_type o) const {
         trace_activity().connect(sf, o);
-        std::unique_lock<std::mutex> guard(b->state->lock);
-        switch (b->state->current) {
+        std::unique_lock<std::mutex> guard(state->lock);
+        switch (state->current) {
         case mode::Casting:
             {
                 if (o.is_subscribed()) {
-                    b->completer = std::make_shared<completer_type>(b->state, b->completer, o);
-                    ++b->state->generation;
+                    auto p = new observer_type(o);
+                    auto slot = state->insert(p);
+                    guard.unlock();
+
+                    std::weak_ptr<state_type> weak = state;
+                    o.add([weak, slot, p](){
+                        auto s = weak.lock();
+                        if (s) {
+                            s->remove(slot, p);
+                        }
+                    });
                 }
             }
             break;
@@ -138,7 +250,7 @@ public:
             break;
         case mode::Errored:
             {
-                auto e = b->state->error;
+                auto e = state->error;
                 guard.unlock();
                 o.on_error(e);
                 return;
@@ -148,56 +260,43 @@ public:
             abort();
         }
     }
+    // every observer sees the same value, an observer that takes it by
+    // value copies it and one that takes a const& does not
     template<class V>
-    void on_next(V v) const {
-        if (b->current_generation != b->state->generation) {
-            std::unique_lock<std::mutex> guard(b->state->lock);
-            b->current_generation = b->state->generation;
-            b->current_completer = b->completer;
-        }
-        if (!b->current_completer || b->current_completer->observers.empty()) {
+    void on_next(V&& v) const {
+        if (state->count == 0) {
             return;
         }
-        for (auto& o : b->current_completer->observers) {
-            if (o.is_subscribed()) {
-                o.on_next(v);
-            }
-        }
+        for_each_observer([&](const observer_type& o){
+            o.on_next(v);
+        });
     }
     void on_error(std::exception_ptr e) const {
-        std::unique_lock<std::mutex> guard(b->state->lock);
-        if (b->state->current == mode::Casting) {
-            b->state->error = e;
-            b->state->current = mode::Errored;
-            auto s = b->state->lifetime;
-            auto c = std::move(b->completer);
-            b->current_completer.reset();
-            ++b->state->generation;
+        std::unique_lock<std::mutex> guard(state->lock);
+        if (state->current == mode::Casting) {
+            state->error = e;
+            state->current = mode::Errored;
+            auto s = state->lifetime;
+            auto observers = take_observers();
             guard.unlock();
-            if (c) {
-                for (auto& o : c->observers) {
-                    if (o.is_subscribed()) {
-                        o.on_error(e);
-                    }
+            for (auto& o : observers) {
+                if (o.is_subscribed()) {
+                    o.on_error(e);
                 }
             }
             s.unsubscribe();
         }
     }
     void on_completed() const {
-        std::unique_lock<std::mutex> guard(b->state->lock);
-        if (b->state->current == mode::Casting) {
-            b->state->current = mode::Completed;
-            auto s = b->state->lifetime;
-            auto c = std::move(b->completer);
-            b->current_completer.reset();
-            ++b->state->generation;
+        std::unique_lock<std::mutex> guard(state->lock);
+        if (state->current == mode::Casting) {
+            state->current = mode::Completed;
+            auto s = state->lifetime;
+            auto observers = take_observers();
             guard.unlock();
-            if (c) {
-                for (auto& o : c->observers) {
-                    if (o.is_subscribed()) {
-                        o.on_completed();
-                    }
+            for (auto& o : observers) {
+                if (o.is_subscribed()) {
+                    o.on_completed();
                 }
             }
             s.unsubscribe();
@@ -0,0 +1,164 @@
+
+namespace ofx {
+
+namespace rx {
+
+/// BufferRef is a refcounted view of a slice of a memory block.
+/// copies share the block, they do not allocate or copy elements.
+/// the block is returned to where it came from when the last view is
+/// destroyed. T must be trivially copyable, elements are not constructed.
+template<class T>
+class BufferRef
+{
+    // elements are assigned into raw block storage, never constructed or
+    // destroyed
+    static_assert(std::is_trivially_copyable<T>::value, "BufferRef<T> requires a trivially copyable T");
+
+    struct header
+    {
+        header(void (*r)(header*), std::shared_ptr<void> o, size_t c)
+            : ref(1)
+            , release(r)
+            , owner(std::move(o))
+            , capacity(c)
+        {
+        }
+        std::atomic<int> ref;
+        void (*release)(header*);
+        // keeps the pool alive while the block is in use
+        std::shared_ptr<void> owner;
+        size_t capacity;
+    };
+
+    header* block;
+    T* first;
+    size_t count;
+
+    static T* data_of(header* h) {
+        return reinterpret_cast<T*>(reinterpret_cast<char*>(h) + overhead_size);
+    }
+
+    static void release_to_heap(header* h) {
+        h->~header();
+        ::operator delete(reinterpret_cast<void*>(h));
+    }
+
+    template<class Pool>
+    static void release_to_pool(header* h) {
+        auto pool = std::static_pointer_cast<Pool>(std::move(h->owner));
+        h->~header();
+        pool->release(reinterpret_cast<void*>(h));
+    }
+
+    BufferRef(header* h, T* f, size_t c)
+        : block(h)
+        , first(f)
+        , count(c)
+    {
+    }
+
+public:
+    /// the bytes in each block that are used by the refcount
+    static const size_t overhead_size = ((sizeof(header) + alignof(T) - 1) / alignof(T)) * alignof(T);
+
+    typedef T value_type;
+    typedef T* iterator;
+    typedef const T* const_iterator;
+
+    /// a block of count elements from the heap
+    static BufferRef<T> allocate(size_t count) {
+        auto memory = ::operator new(overhead_size + (count * sizeof(T)));
+        auto h = new (memory) header(&release_to_heap, std::shared_ptr<void>(), count);
+        return BufferRef<T>(h, data_of(h), count);
+    }
+
+    /// a block from pool. Pool must have get(), release(void*) and
+    /// blockSize(), as Poco::MemoryPool does.
+    template<class Pool>
+    static BufferRef<T> from_pool(std::shared_ptr<Pool> pool) {
+        assert(pool->blockSize() >= overhead_size + sizeof(T));
+        auto count = (pool->blockSize() - overhead_size) / sizeof(T);
+        auto memory = pool->get();
+        auto h = new (memory) header(&release_to_pool<Pool>, std::move(pool), count);
+        return BufferRef<T>(h, data_of(h), count);
+    }
+
+    BufferRef()
+        : block(nullptr)
+        , first(nullptr)
+        , count(0)
+    {
+    }
+    ~BufferRef()
+    {
+        if (block && block->ref.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            block->release(block);
+        }
+        block = nullptr;
+    }
+    BufferRef(const BufferRef<T>& o)
+        : block(o.block)
+        , first(o.first)
+        , count(o.count)
+    {
+        if (block) {
+            block->ref.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    BufferRef(BufferRef<T>&& o)
+        : block(o.block)
+        , first(o.first)
+        , count(o.count)
+    {
+        o.block = nullptr;
+        o.first = nullptr;
+        o.count = 0;
+    }
+    BufferRef<T>& operator=(BufferRef<T> o)
+    {
+        swap(o);
+        return *this;
+    }
+    void swap(BufferRef<T>& o)
+    {
+        using std::swap;
+        swap(block, o.block);
+        swap(first, o.first);
+        swap(count, o.count);
+    }
+
+    iterator begin() {return first;}
+    iterator end() {return first+count;}
+    const_iterator begin() const {return first;}
+    const_iterator end() const {return first+count;}
+    T* data() {return first;}
+    const T* data() const {return first;}
+    size_t size() const {return count;}
+    bool empty() const {return count == 0;}
+
+    /// the number of views that share the block
+    int use_count() const {
+        return block ? block->ref.load() : 0;
+    }
+
+    /// shrinks the view to the first c elements
+    void resize(size_t c) {assert(c <= count); count = c;}
+
+    /// a view of length elements starting at offset that shares the block
+    BufferRef<T> slice(size_t offset, size_t length) const {
+        assert(offset + length <= count);
+        BufferRef<T> result(*this);
+        result.first += offset;
+        result.count = length;
+        return result;
+    }
+};
+
+template<class T>
+inline void swap(BufferRef<T>& lhs, BufferRef<T>& rhs) {
+    lhs.swap(rhs);
+}
+
+}
+
+}
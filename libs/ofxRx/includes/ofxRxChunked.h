@@ -0,0 +1,468 @@
+
+namespace ofx {
+
+namespace rx {
+
+/// the chunked operators move values as BufferRef slices so that map,
+/// filter, sum and average run a tight loop over each chunk instead of
+/// a call through the subscriber for each value.
+///
+///     values |
+///         chunked::chunk(256) |
+///         chunked::map([](float v){return v * 2;}) |
+///         chunked::filter([](float v){return v > 0;}) |
+///         chunked::sum()
+///
+namespace chunked {
+
+namespace detail {
+
+// values -> chunks of up to size values
+template<class T>
+struct chunk
+{
+    typedef typename std::decay<T>::type source_value_type;
+    typedef BufferRef<source_value_type> value_type;
+
+    static_assert(std::is_trivially_copyable<source_value_type>::value, "chunk() requires trivially copyable values, they are assigned into raw pool storage");
+
+    std::size_t size;
+
+    explicit chunk(std::size_t s)
+        : size(std::max<std::size_t>(s, 1))
+    {
+    }
+
+    template<class Subscriber>
+    struct chunk_observer
+    {
+        typedef chunk_observer<Subscriber> this_type;
+        typedef typename std::decay<Subscriber>::type dest_type;
+        typedef rx::observer<source_value_type, this_type> observer_type;
+        dest_type dest;
+        std::size_t size;
+        mutable value_type current;
+        mutable std::size_t filled;
+
+        chunk_observer(dest_type d, std::size_t s)
+            : dest(std::move(d))
+            , size(s)
+            , filled(0)
+        {
+        }
+        void on_next(source_value_type v) const {
+            if (current.empty()) {
+                current = value_type::allocate(size);
+                filled = 0;
+            }
+            current.begin()[filled++] = std::move(v);
+            if (filled == size) {
+                value_type full;
+                full.swap(current);
+                dest.on_next(std::move(full));
+            }
+        }
+        void on_error(std::exception_ptr e) const {
+            dest.on_error(e);
+        }
+        void on_completed() const {
+            if (!current.empty()) {
+                value_type partial;
+                partial.swap(current);
+                partial.resize(filled);
+                dest.on_next(std::move(partial));
+            }
+            dest.on_completed();
+        }
+
+        static rx::subscriber<source_value_type, observer_type> make(dest_type d, std::size_t s) {
+            auto cs = d.get_subscription();
+            return rx::make_subscriber<source_value_type>(std::move(cs), observer_type(this_type(std::move(d), s)));
+        }
+    };
+
+    template<class Subscriber>
+    auto operator()(Subscriber dest) const
+        -> decltype(chunk_observer<Subscriber>::make(std::move(dest), size)) {
+        return      chunk_observer<Subscriber>::make(std::move(dest), size);
+    }
+};
+
+// chunks -> values
+template<class T>
+struct values
+{
+    typedef BufferRef<T> source_value_type;
+    typedef T value_type;
+
+    template<class Subscriber>
+    struct values_observer
+    {
+        typedef values_observer<Subscriber> this_type;
+        typedef typename std::decay<Subscriber>::type dest_type;
+        typedef rx::observer<source_value_type, this_type> observer_type;
+        dest_type dest;
+
+        explicit values_observer(dest_type d)
+            : dest(std::move(d))
+        {
+        }
+        void on_next(const source_value_type& c) const {
+            for (auto& v : c) {
+                if (!dest.is_subscribed()) {
+                    return;
+                }
+                dest.on_next(v);
+            }
+        }
+        void on_error(std::exception_ptr e) const {
+            dest.on_error(e);
+        }
+        void on_completed() const {
+            dest.on_completed();
+        }
+
+        static rx::subscriber<source_value_type, observer_type> make(dest_type d) {
+            auto cs = d.get_subscription();
+            return rx::make_subscriber<source_value_type>(std::move(cs), observer_type(this_type(std::move(d))));
+        }
+    };
+
+    template<class Subscriber>
+    auto operator()(Subscriber dest) const
+        -> decltype(values_observer<Subscriber>::make(std::move(dest))) {
+        return      values_observer<Subscriber>::make(std::move(dest));
+    }
+};
+
+template<class T, class Selector>
+struct map
+{
+    typedef BufferRef<T> source_value_type;
+    typedef typename std::decay<Selector>::type select_type;
+    typedef typename std::decay<decltype((*(select_type*)nullptr)(*(T*)nullptr))>::type result_type;
+    typedef BufferRef<result_type> value_type;
+
+    select_type selector;
+
+    explicit map(select_type s)
+        : selector(std::move(s))
+    {
+    }
+
+    template<class Subscriber>
+    struct map_observer
+    {
+        typedef map_observer<Subscriber> this_type;
+        typedef typename std::decay<Subscriber>::type dest_type;
+        typedef rx::observer<source_value_type, this_type> observer_type;
+        dest_type dest;
+        select_type selector;
+
+        map_observer(dest_type d, select_type s)
+            : dest(std::move(d))
+            , selector(std::move(s))
+        {
+        }
+
+        // a chunk that is not shared is mapped in place
+        static value_type output_for(source_value_type& c, std::true_type) {
+            if (c.use_count() == 1) {
+                return std::move(c);
+            }
+            return value_type::allocate(c.size());
+        }
+        static value_type output_for(source_value_type& c, std::false_type) {
+            return value_type::allocate(c.size());
+        }
+
+        void on_next(source_value_type c) const {
+            auto mapped = rx::on_exception(
+                [&](){
+                    const auto count = c.size();
+                    const T* in = c.data();
+                    auto out = output_for(c, std::is_same<T, result_type>());
+                    result_type* o = out.data();
+                    for (std::size_t i = 0; i != count; ++i) {
+                        o[i] = this->selector(in[i]);
+                    }
+                    return out;
+                },
+                dest);
+            if (mapped.empty()) {
+                return;
+            }
+            dest.on_next(std::move(mapped.get()));
+        }
+        void on_error(std::exception_ptr e) const {
+            dest.on_error(e);
+        }
+        void on_completed() const {
+            dest.on_completed();
+        }
+
+        static rx::subscriber<source_value_type, observer_type> make(dest_type d, select_type s) {
+            auto cs = d.get_subscription();
+            return rx::make_subscriber<source_value_type>(std::move(cs), observer_type(this_type(std::move(d), std::move(s))));
+        }
+    };
+
+    template<class Subscriber>
+    auto operator()(Subscriber dest) const
+        -> decltype(map_observer<Subscriber>::make(std::move(dest), selector)) {
+        return      map_observer<Subscriber>::make(std::move(dest), selector);
+    }
+};
+
+template<class T, class Predicate>
+struct filter
+{
+    typedef BufferRef<T> source_value_type;
+    typedef source_value_type value_type;
+    typedef typename std::decay<Predicate>::type test_type;
+
+    test_type test;
+
+    explicit filter(test_type t)
+        : test(std::move(t))
+    {
+    }
+
+    template<class Subscriber>
+    struct filter_observer
+    {
+        typedef filter_observer<Subscriber> this_type;
+        typedef typename std::decay<Subscriber>::type dest_type;
+        typedef rx::observer<source_value_type, this_type> observer_type;
+        dest_type dest;
+        test_type test;
+
+        filter_observer(dest_type d, test_type t)
+            : dest(std::move(d))
+            , test(std::move(t))
+        {
+        }
+        void on_next(source_value_type c) const {
+            auto kept = rx::on_exception(
+                [&](){
+                    const auto count = c.size();
+                    const T* in = c.data();
+                    // a chunk that is not shared is compacted in place
+                    auto out = c.use_count() == 1 ? std::move(c) : value_type::allocate(count);
+                    T* o = out.data();
+                    std::size_t n = 0;
+                    for (std::size_t i = 0; i != count; ++i) {
+                        o[n] = in[i];
+                        n += this->test(in[i]) ? 1 : 0;
+                    }
+                    out.resize(n);
+                    return out;
+                },
+                dest);
+            if (kept.empty() || kept.get().empty()) {
+                return;
+            }
+            dest.on_next(std::move(kept.get()));
+        }
+        void on_error(std::exception_ptr e) const {
+            dest.on_error(e);
+        }
+        void on_completed() const {
+            dest.on_completed();
+        }
+
+        static rx::subscriber<source_value_type, observer_type> make(dest_type d, test_type t) {
+            auto cs = d.get_subscription();
+            return rx::make_subscriber<source_value_type>(std::move(cs), observer_type(this_type(std::move(d), std::move(t))));
+        }
+    };
+
+    template<class Subscriber>
+    auto operator()(Subscriber dest) const
+        -> decltype(filter_observer<Subscriber>::make(std::move(dest), test)) {
+        return      filter_observer<Subscriber>::make(std::move(dest), test);
+    }
+};
+
+// sum and average of all the values in all the chunks, emitted on completion
+template<class T, class Result, bool Average>
+struct total
+{
+    typedef BufferRef<T> source_value_type;
+    typedef Result value_type;
+
+    template<class Subscriber>
+    struct total_observer
+    {
+        typedef total_observer<Subscriber> this_type;
+        typedef typename std::decay<Subscriber>::type dest_type;
+        typedef rx::observer<source_value_type, this_type> observer_type;
+        dest_type dest;
+        mutable Result accumulated;
+        mutable std::size_t count;
+
+        explicit total_observer(dest_type d)
+            : dest(std::move(d))
+            , accumulated()
+            , count(0)
+        {
+        }
+        void on_next(const source_value_type& c) const {
+            const auto size = c.size();
+            const T* in = c.data();
+            Result partial = Result();
+            for (std::size_t i = 0; i != size; ++i) {
+                partial += in[i];
+            }
+            accumulated += partial;
+            count += size;
+        }
+        void on_error(std::exception_ptr e) const {
+            dest.on_error(e);
+        }
+        void on_completed() const {
+            if (Average && count != 0) {
+                dest.on_next(accumulated / count);
+            } else {
+                dest.on_next(accumulated);
+            }
+            dest.on_completed();
+        }
+
+        static rx::subscriber<source_value_type, observer_type> make(dest_type d) {
+            auto cs = d.get_subscription();
+            return rx::make_subscriber<source_value_type>(std::move(cs), observer_type(this_type(std::move(d))));
+        }
+    };
+
+    template<class Subscriber>
+    auto operator()(Subscriber dest) const
+        -> decltype(total_observer<Subscriber>::make(std::move(dest))) {
+        return      total_observer<Subscriber>::make(std::move(dest));
+    }
+};
+
+// the value type of the chunks in an observable of BufferRef
+template<class Observable>
+struct element_of
+{
+    typedef typename std::decay<Observable>::type::value_type::value_type type;
+};
+
+class chunk_factory
+{
+    std::size_t size;
+public:
+    explicit chunk_factory(std::size_t s) : size(s) {}
+    template<class Observable>
+    auto operator()(Observable&& source)
+        -> decltype(source.template lift<BufferRef<typename std::decay<Observable>::type::value_type>>(chunk<typename std::decay<Observable>::type::value_type>(size))) {
+        return      source.template lift<BufferRef<typename std::decay<Observable>::type::value_type>>(chunk<typename std::decay<Observable>::type::value_type>(size));
+    }
+};
+
+class values_factory
+{
+public:
+    template<class Observable>
+    auto operator()(Observable&& source)
+        -> decltype(source.template lift<typename element_of<Observable>::type>(values<typename element_of<Observable>::type>())) {
+        return      source.template lift<typename element_of<Observable>::type>(values<typename element_of<Observable>::type>());
+    }
+};
+
+template<class Selector>
+class map_factory
+{
+    typedef typename std::decay<Selector>::type select_type;
+    select_type selector;
+public:
+    explicit map_factory(select_type s) : selector(std::move(s)) {}
+    template<class Observable>
+    auto operator()(Observable&& source)
+        -> decltype(source.template lift<typename map<typename element_of<Observable>::type, select_type>::value_type>(map<typename element_of<Observable>::type, select_type>(selector))) {
+        return      source.template lift<typename map<typename element_of<Observable>::type, select_type>::value_type>(map<typename element_of<Observable>::type, select_type>(selector));
+    }
+};
+
+template<class Predicate>
+class filter_factory
+{
+    typedef typename std::decay<Predicate>::type test_type;
+    test_type test;
+public:
+    explicit filter_factory(test_type t) : test(std::move(t)) {}
+    template<class Observable>
+    auto operator()(Observable&& source)
+        -> decltype(source.template lift<BufferRef<typename element_of<Observable>::type>>(filter<typename element_of<Observable>::type, test_type>(test))) {
+        return      source.template lift<BufferRef<typename element_of<Observable>::type>>(filter<typename element_of<Observable>::type, test_type>(test));
+    }
+};
+
+class sum_factory
+{
+public:
+    template<class Observable>
+    auto operator()(Observable&& source)
+        -> decltype(source.template lift<typename element_of<Observable>::type>(total<typename element_of<Observable>::type, typename element_of<Observable>::type, false>())) {
+        return      source.template lift<typename element_of<Observable>::type>(total<typename element_of<Observable>::type, typename element_of<Observable>::type, false>());
+    }
+};
+
+class average_factory
+{
+public:
+    template<class Observable>
+    auto operator()(Observable&& source)
+        -> decltype(source.template lift<double>(total<typename element_of<Observable>::type, double, true>())) {
+        return      source.template lift<double>(total<typename element_of<Observable>::type, double, true>());
+    }
+};
+
+}
+
+/// values -> chunks of up to size values
+inline auto chunk(std::size_t size)
+    ->      detail::chunk_factory {
+    return  detail::chunk_factory(size);
+}
+
+/// chunks -> values
+inline auto values()
+    ->      detail::values_factory {
+    return  detail::values_factory();
+}
+
+/// maps every value in each chunk. a chunk is mapped in place when it is
+/// not shared and the result has the same type.
+template<class Selector>
+auto map(Selector s)
+    ->      detail::map_factory<Selector> {
+    return  detail::map_factory<Selector>(std::move(s));
+}
+
+/// keeps the values in each chunk that pass the test. empty chunks are
+/// dropped. a chunk is compacted in place when it is not shared.
+template<class Predicate>
+auto filter(Predicate p)
+    ->      detail::filter_factory<Predicate> {
+    return  detail::filter_factory<Predicate>(std::move(p));
+}
+
+/// the sum of all the values, emitted on completion
+inline auto sum()
+    ->      detail::sum_factory {
+    return  detail::sum_factory();
+}
+
+/// the average of all the values, emitted on completion
+inline auto average()
+    ->      detail::average_factory {
+    return  detail::average_factory();
+}
+
+}
+
+}
+
+}
@@ -40,11 +40,90 @@ namespace ofx {
 namespace rx {
 
 
+/// HttpLoad counts the requests of a pooled HttpClient.
+struct HttpLoad
+{
+    HttpLoad() : inFlight(0), queued(0)
+    {
+    }
+    /// requests that have a connection
+    std::size_t inFlight;
+    /// requests waiting for a connection
+    std::size_t queued;
+};
+
+
+namespace detail {
+
+/// HttpConnectionPool limits the number of requests in flight and keeps the
+/// contexts of finished requests per host, so that the keep-alive session
+/// in a context is reused by the next request to the same host.
+/// requests on one session run one after another, they are not pipelined.
+/// the client session sends a request only after the previous response was
+/// read, so requests to one host run in parallel on separate sessions.
+class HttpConnectionPool: public std::enable_shared_from_this<HttpConnectionPool>
+{
+public:
+    typedef std::function<void(std::shared_ptr<HTTP::Context>, rx::composite_subscription)> start_type;
+
+    HttpConnectionPool(std::size_t concurrency, rxsc::scheduler scheduler);
+
+    /// start is called on the scheduler with a context for host and the
+    /// lifetime of its worker when a connection is free. the worker runs
+    /// until start unsubscribes that lifetime. the request is dropped if
+    /// lifetime is unsubscribed before then.
+    void enqueue(const std::string& host, rx::composite_subscription lifetime, start_type start);
+
+    /// returns the context of a finished request. a context is only
+    /// reused when the whole response was read.
+    void release(const std::string& host, std::shared_ptr<HTTP::Context> context, bool reusable);
+
+    rx::observable<HttpLoad> load() const;
+
+private:
+    struct waiting_type
+    {
+        std::string host;
+        rx::composite_subscription lifetime;
+        start_type start;
+    };
+
+    void dispatch();
+    void publish();
+
+    const std::size_t _concurrency;
+    rxsc::scheduler _scheduler;
+
+    std::mutex _lock;
+    std::size_t _inFlight;
+    std::deque<waiting_type> _waiting;
+    std::map<std::string, std::vector<std::shared_ptr<HTTP::Context>>> _idle;
+
+    // on_next is called from the threads that change the counts
+    std::recursive_mutex _publishLock;
+    rx::subjects::behavior<HttpLoad> sub_load;
+    rx::subscriber<HttpLoad> dest_load;
+};
+
+}
+
+
 class HttpClient
 {
 public:
     HttpClient();
 
+    /// \brief Construct a client that pools connections.
+    /// \param concurrency The most requests in flight at once.
+    /// \param scheduler The requests are submitted on workers of this scheduler.
+    ///
+    /// Requests to the same host reuse keep-alive connections. Requests
+    /// past the concurrency limit wait in a queue. A request blocks its
+    /// worker while it runs, so the default gives each request a thread of
+    /// its own, taken from a pool of parked threads.
+    explicit HttpClient(std::size_t concurrency,
+                        rxsc::scheduler scheduler = rxsc::make_pooled_thread());
+
     rx::observable<HttpProgress> get(const std::string& uri,
                    const Poco::Net::NameValueCollection& formFields = Poco::Net::NameValueCollection(),
                    const std::string& httpVersion = Poco::Net::HTTPMessage::HTTP_1_1,
@@ -71,10 +150,18 @@ public:
     ///
     rx::observable<HttpProgress> request(HTTP::BaseRequest* pRequest);
 
+    /// \brief The requests in flight and queued.
+    ///
+    /// Emits the current counts on subscribe and whenever they change.
+    /// Never emits for a client that does not pool connections.
+    rx::observable<HttpLoad> load() const;
+
 private:
     HttpClient(const HttpClient&);
     HttpClient& operator = (const HttpClient&);
 
+    std::shared_ptr<detail::HttpConnectionPool> pool;
+
 };
 
 
@@ -34,68 +34,90 @@ namespace ofx {
 
 namespace rx {
 
-template<class T>
-class BufferRef : public HTTP::BaseClientResponseArgs
+/// HttpChunk is a piece of a response body and the response it belongs to.
+class HttpChunk : public BufferRef<char>, public HTTP::BaseClientResponseArgs
 {
-    struct counted_buffer
+public:
+    HttpChunk(BufferRef<char> b, HTTP::BaseClientResponseArgs o):
+        BufferRef<char>(std::move(b)),
+        HTTP::BaseClientResponseArgs(o)
     {
-        std::atomic<int> ref;
-        T buffy[1];
+    }
+};
+
+/// the pool that all response bodies read their chunks into.
+/// chunks return to the pool when the last BufferRef to them is destroyed.
+std::shared_ptr<Poco::MemoryPool> http_buffer_pool();
+
+/// HttpBody is an immutable chain of the chunks of a response body.
+/// append shares the chunks already in the chain, no bytes are copied.
+class HttpBody
+{
+    struct link
+    {
+        link(BufferRef<char> c, std::shared_ptr<const link> p)
+            : chunk(std::move(c))
+            , previous(std::move(p))
+        {
+        }
+        BufferRef<char> chunk;
+        std::shared_ptr<const link> previous;
     };
-    std::shared_ptr<Poco::MemoryPool> pool;
-    counted_buffer* counted;
+    std::shared_ptr<const link> last;
     size_t count;
+    size_t bytes;
+
 public:
-    static const size_t overhead_size = sizeof(counted_buffer) - sizeof(T);
-    typedef T value_type;
-    typedef T* iterator;
-    ~BufferRef()
+    HttpBody()
+        : count(0)
+        , bytes(0)
     {
-        if (counted && counted->ref-- == 0) {
-            pool->release(reinterpret_cast<void*>(counted));
+    }
+
+    HttpBody append(BufferRef<char> chunk) const {
+        HttpBody result;
+        result.count = count + 1;
+        result.bytes = bytes + chunk.size();
+        result.last = std::make_shared<const link>(std::move(chunk), last);
+        return result;
+    }
+
+    /// the number of chunks
+    size_t chunks() const {
+        return count;
+    }
+    /// the number of bytes in all the chunks
+    size_t size() const {
+        return bytes;
+    }
+
+    /// calls f with each chunk in the order they were received
+    template<class F>
+    void for_each_chunk(F f) const {
+        std::vector<const BufferRef<char>*> ordered;
+        ordered.reserve(count);
+        for (auto l = last.get(); l; l = l->previous.get()) {
+            ordered.push_back(&l->chunk);
+        }
+        for (auto c = ordered.rbegin(); c != ordered.rend(); ++c) {
+            f(**c);
         }
-        counted = nullptr;
-    }
-    BufferRef(std::shared_ptr<Poco::MemoryPool> p,
-              size_t byteCount,
-              HTTP::BaseClientResponseArgs o):
-        HTTP::BaseClientResponseArgs(o),
-        counted(reinterpret_cast<counted_buffer*>(p->get())),
-        count((byteCount - overhead_size) / sizeof(T))
-    {
-        counted->ref = 1;
-        assert((count*sizeof(T))+overhead_size == byteCount);
-    }
-    BufferRef(const BufferRef<T>& o):
-        HTTP::BaseClientResponseArgs(o),
-        pool(o.pool),
-        counted(o.counted),
-        count(o.count)
-    {
-        counted->ref++;
     }
-    BufferRef(BufferRef<T>&& o):
-        HTTP::BaseClientResponseArgs(std::move(o)),
-        pool(std::move(o.pool)),
-        counted(std::move(o.counted)),
-        count(std::move(o.count))
-    {
-        o.counted = nullptr;
-        o.count = 0;
+
+    /// copies the chunks into one buffer with a single allocation
+    std::shared_ptr<ofBuffer> collect() const {
+        auto buffer = std::make_shared<ofBuffer>();
+        buffer->allocate(bytes);
+        auto cursor = buffer->getBinaryBuffer();
+        for_each_chunk([&](const BufferRef<char>& chunk){
+            cursor = std::copy(chunk.begin(), chunk.end(), cursor);
+        });
+        return buffer;
     }
-    BufferRef<T>& operator=(BufferRef<T> o)
-    {
-        using std::swap;
-        swap(pool, o.pool);
-        swap(counted, o.counted);
-        swap(count, o.count);
-    }
-    iterator begin() {return counted->buffy;}
-    iterator end() {return counted->buffy+count;}
-    size_t size() {return count;}
-    void resize(size_t c) {assert(c <= count);}
 };
 
+class HttpProgress;
+
 namespace detail {
 
     class HttpProgressState: public HTTP::DefaultClient, public std::enable_shared_from_this<HttpProgressState>
@@ -104,7 +126,7 @@ public:
     ~HttpProgressState();
     HttpProgressState(std::shared_ptr<HTTP::BaseRequest> request,
                         HTTP::BaseResponse* response,
-                        HTTP::Context* context);
+                        std::shared_ptr<HTTP::Context> context);
 
     void submit();
 
@@ -119,20 +141,20 @@ public:
 
     rx::subjects::subject<HTTP::ClientRequestProgressArgs> sub_request;
     rx::subjects::subject<HTTP::ClientResponseProgressArgs> sub_response;
-    rx::subjects::subject<BufferRef<char>> sub_body;
+    rx::subjects::subject<HttpChunk> sub_body;
 
 private:
-    const std::size_t bufferSize = IO::ByteBufferUtils::DEFAULT_BUFFER_SIZE;
-
     std::shared_ptr<HTTP::BaseRequest> _request;
     HTTP::BaseResponse* _response;
-    HTTP::Context* _context;
-    
-    std::shared_ptr<Poco::MemoryPool> pool;
+    std::shared_ptr<HTTP::Context> _context;
+    std::atomic<bool> _failed;
+    std::atomic<bool> _complete;
+
+    friend class ofx::rx::HttpProgress;
 
     rx::subscriber<HTTP::ClientRequestProgressArgs> dest_request;
     rx::subscriber<HTTP::ClientResponseProgressArgs> dest_response;
-    rx::subscriber<BufferRef<char>> dest_body;
+    rx::subscriber<HttpChunk> dest_body;
 
 };
 }
@@ -143,7 +165,15 @@ public:
     HttpProgress(std::shared_ptr<HTTP::BaseRequest> request,
                     HTTP::BaseResponse* response,
                     HTTP::Context* context)
-        : state(std::make_shared<detail::HttpProgressState>(request, response, context))
+        : state(std::make_shared<detail::HttpProgressState>(request, response, std::shared_ptr<HTTP::Context>(context)))
+    {
+    }
+    /// the context may be shared by requests that run one after another.
+    /// a keep-alive session in the context is reused by the next request.
+    HttpProgress(std::shared_ptr<HTTP::BaseRequest> request,
+                    HTTP::BaseResponse* response,
+                    std::shared_ptr<HTTP::Context> context)
+        : state(std::make_shared<detail::HttpProgressState>(request, response, std::move(context)))
     {
     }
 
@@ -151,16 +181,44 @@ public:
         state->submit();
     }
 
+    /// true when the request ended with an error
+    inline bool failed() const {
+        return state->_failed;
+    }
+
+    /// true when the whole response body was read. a request that was
+    /// unsubscribed before the end of the body leaves bytes in the stream.
+    inline bool complete() const {
+        return state->_complete;
+    }
+
     inline rx::observable<HTTP::ClientRequestProgressArgs> request() const {
         return state->sub_request.get_observable();
     }
     inline rx::observable<HTTP::ClientResponseProgressArgs> response() const {
         return state->sub_response.get_observable();
     }
-    inline rx::observable<BufferRef<char>> body() const {
+    inline rx::observable<HttpChunk> body() const {
         return state->sub_body.get_observable();
     }
 
+    /// emits the body received so far each time a chunk arrives.
+    /// the chunks are shared with body(), not copied.
+    inline rx::observable<HttpBody> chunks() const {
+        return body().
+            scan(
+                HttpBody(),
+                [](HttpBody acc, HttpChunk chunk){
+                    return acc.append(std::move(chunk));
+                }).
+            as_dynamic();
+    }
+
+    /// emits the whole body as one buffer when the response completes.
+    /// the buffer is allocated once from the Content-Length header and
+    /// each chunk is copied into place and released as it arrives.
+    rx::observable<std::shared_ptr<ofBuffer>> collect() const;
+
 private:
     mutable std::shared_ptr<detail::HttpProgressState> state;
 };
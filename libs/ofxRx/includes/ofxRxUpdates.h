@@ -29,6 +29,100 @@ private:
     rx::subscriber<ofEventArgs> dest_updates;
 };
 
+/// update_budget limits the time that an update scheduler spends running
+/// actions in each frame. all the workers of the scheduler share the budget.
+/// due actions that do not fit run in the next frame. with a budget, an
+/// action that recurses, like the drain of observe_on, is queued again
+/// instead of looping in place, so a burst is spread over several frames.
+class update_budget
+{
+public:
+    typedef rxsc::scheduler::clock_type clock_type;
+
+private:
+    struct state_type
+    {
+        explicit state_type(clock_type::duration b)
+            : budget(b)
+            , frame(0)
+            , started(false)
+            , overrun(false)
+            , frames(0)
+            , overruns(0)
+            , backlog(0)
+        {
+        }
+        clock_type::duration budget;
+
+        // only used on the main thread
+        uint64_t frame;
+        bool started;
+        bool overrun;
+        clock_type::time_point deadline;
+
+        std::atomic<size_t> frames;
+        std::atomic<size_t> overruns;
+        std::atomic<size_t> backlog;
+    };
+    std::shared_ptr<state_type> state;
+
+public:
+    /// no limit, only the counters are kept
+    update_budget()
+        : state(std::make_shared<state_type>(clock_type::duration::zero()))
+    {
+    }
+    explicit update_budget(clock_type::duration per_frame)
+        : state(std::make_shared<state_type>(per_frame))
+    {
+    }
+
+    /// the time allowed per frame, zero when there is no limit
+    clock_type::duration budget() const {
+        return state->budget;
+    }
+    /// the number of frames that have run actions
+    size_t frames() const {
+        return state->frames;
+    }
+    /// the number of frames that ended with due actions carried over
+    size_t overruns() const {
+        return state->overruns;
+    }
+    /// the number of actions waiting in the workers, due or not
+    size_t backlog() const {
+        return state->backlog;
+    }
+
+    /// returns the deadline for the current frame.
+    /// the first worker to run in a frame starts the clock.
+    clock_type::time_point begin_frame(clock_type::time_point now) const {
+        uint64_t frame = ofGetFrameNum();
+        if (!state->started || state->frame != frame) {
+            state->started = true;
+            state->frame = frame;
+            state->overrun = false;
+            ++state->frames;
+            state->deadline = state->budget == clock_type::duration::zero() ?
+                clock_type::time_point::max() :
+                now + state->budget;
+        }
+        return state->deadline;
+    }
+    void overrun() const {
+        if (!state->overrun) {
+            state->overrun = true;
+            ++state->overruns;
+        }
+    }
+    void queued() const {
+        ++state->backlog;
+    }
+    void dequeued(size_t count = 1) const {
+        state->backlog -= count;
+    }
+};
+
 struct update : public rxsc::scheduler_interface
 {
 private:
@@ -46,25 +140,131 @@ private:
 
         struct worker_state : public std::enable_shared_from_this<worker_state>
         {
-            typedef rxsc::detail::schedulable_queue<
+            typedef rxsc::detail::timed_queue<
                 typename clock_type::time_point> queue_item_time;
 
             typedef queue_item_time::item_type item_type;
 
+            // a posted action in the inbox
+            struct posted_node
+            {
+                explicit posted_node(item_type i)
+                    : item(std::move(i))
+                    , next(nullptr)
+                {
+                }
+                item_type item;
+                posted_node* next;
+            };
+
             virtual ~worker_state()
             {
+                auto node = inbox.exchange(nullptr);
+                while (node) {
+                    auto next = node->next;
+                    delete node;
+                    node = next;
+                }
+                budget.dequeued(queued);
             }
 
-            explicit worker_state(rx::composite_subscription cs)
+            worker_state(rx::composite_subscription cs, update_budget b, rxsc::timer_kind::type timers)
                 : lifetime(cs)
+                , queue(timers)
+                , inbox(nullptr)
+                , queued(0)
+                , budget(std::move(b))
             {
             }
 
+            // must be called with lock held
+            void push(item_type item) const {
+                queue.push(std::move(item));
+                ++queued;
+                budget.queued();
+            }
+
+            // called from any thread. the action is stamped with the time
+            // it was posted, so that it runs in order with the timed actions.
+            // the inbox is a stack that the producers push onto without a
+            // lock.
+            void post(rxsc::schedulable s) const {
+                auto node = new posted_node(item_type(clock_type::now(), std::move(s)));
+                ++queued;
+                budget.queued();
+                node->next = inbox.load(std::memory_order_relaxed);
+                while (!inbox.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed)) {
+                }
+            }
+
+            // must only be called on the main thread. empties the inbox in
+            // one exchange and appends the actions to posted, oldest first.
+            void take_posted() const {
+                // an empty inbox is not written, so that the producers keep
+                // the cache line
+                if (!inbox.load(std::memory_order_relaxed)) {
+                    return;
+                }
+                auto node = inbox.exchange(nullptr, std::memory_order_acquire);
+                // the newest action is on the top of the stack
+                posted_node* oldest = nullptr;
+                while (node) {
+                    auto next = node->next;
+                    node->next = oldest;
+                    oldest = node;
+                    node = next;
+                }
+                while (oldest) {
+                    posted.push_back(std::move(oldest->item));
+                    auto next = oldest->next;
+                    delete oldest;
+                    oldest = next;
+                }
+            }
+
+            // must only be called on the main thread. moves the timed
+            // actions that are due by now to due, in the order of their times.
+            void take_due(clock_type::time_point now) const {
+                std::unique_lock<std::mutex> guard(lock);
+                while (!queue.empty() && queue.top().when <= now) {
+                    due.push_back(queue.top());
+                    queue.pop();
+                }
+            }
+
+            // must only be called on the main thread. puts the due actions
+            // that did not run back in the timed queue.
+            void return_due() const {
+                if (due.empty()) {
+                    return;
+                }
+                std::unique_lock<std::mutex> guard(lock);
+                for (auto& item : due) {
+                    queue.push(std::move(item));
+                }
+                due.clear();
+            }
+
+            void dequeued() const {
+                --queued;
+                budget.dequeued();
+            }
+
             Updates source;
 
             rx::composite_subscription lifetime;
             mutable std::mutex lock;
+            // delayed actions
             mutable queue_item_time queue;
+            // immediate actions, posted without the lock
+            mutable std::atomic<posted_node*> inbox;
+            // the actions taken for the current frame, only used on the
+            // main thread
+            mutable std::deque<item_type> posted;
+            mutable std::deque<item_type> due;
+            mutable std::atomic<size_t> queued;
+            update_budget budget;
+            // only used on the main thread
             rxsc::recursion r;
         };
 
@@ -80,8 +280,8 @@ private:
         {
         }
 
-        worker_type(rx::composite_subscription cs)
-            : state(std::make_shared<worker_state>(cs))
+        worker_type(rx::composite_subscription cs, update_budget budget, rxsc::timer_kind::type timers)
+            : state(std::make_shared<worker_state>(cs, std::move(budget), timers))
         {
             state->source.setup();
 
@@ -91,25 +291,67 @@ private:
                 state->lifetime,
                 [keepAlive](const ofEventArgs&){
 
-                    for(;;) {
-                        std::unique_lock<std::mutex> guard(keepAlive->lock);
-                        if (keepAlive->queue.empty() || !keepAlive->lifetime.is_subscribed()) {
-                            break;
-                        }
-                        auto& peek = keepAlive->queue.top();
-                        if (!peek.what.is_subscribed()) {
-                            keepAlive->queue.pop();
-                            continue;
+                    // everything that is due runs in this frame, including
+                    // the actions that are posted while the frame runs,
+                    // until the budget is spent. a timed action runs in the
+                    // first frame that starts after it is due, so an action
+                    // can wait for the next frame by scheduling itself now.
+                    auto started = clock_type::now();
+                    auto deadline = keepAlive->budget.begin_frame(started);
+                    bool limited = deadline != clock_type::time_point::max();
+                    bool ran = false;
+                    // each worker runs at least one action per frame
+                    auto over_budget = [&](){
+                        if (limited && ran && deadline <= clock_type::now()) {
+                            keepAlive->budget.overrun();
+                            return true;
                         }
-                        if (clock_type::now() < peek.when) {
+                        return false;
+                    };
+
+                    auto& posted = keepAlive->posted;
+                    auto& due = keepAlive->due;
+
+                    // each round takes the posted actions in one exchange and
+                    // the due timed actions under one lock, then runs them
+                    // without the lock in the order of their times. actions
+                    // scheduled while a round runs are taken by the next one.
+                    for (bool stopped = false; !stopped;) {
+                        keepAlive->take_posted();
+                        keepAlive->take_due(started);
+                        if (posted.empty() && due.empty()) {
                             break;
                         }
-                        auto what = peek.what;
-                        keepAlive->queue.pop();
-                        keepAlive->r.reset(keepAlive->queue.empty());
-                        guard.unlock();
-                        what(keepAlive->r.get_recurse());
+                        while (!posted.empty() || !due.empty()) {
+                            if (!keepAlive->lifetime.is_subscribed()) {
+                                stopped = true;
+                                break;
+                            }
+                            bool timed_first = !due.empty() && (posted.empty() || due.front().when <= posted.front().when);
+                            auto& next = timed_first ? due.front() : posted.front();
+                            if (next.what.is_subscribed() && over_budget()) {
+                                stopped = true;
+                                break;
+                            }
+                            auto what = std::move(next.what);
+                            if (timed_first) {
+                                due.pop_front();
+                            } else {
+                                posted.pop_front();
+                            }
+                            keepAlive->dequeued();
+                            if (!what.is_subscribed()) {
+                                continue;
+                            }
+                            ran = true;
+                            // with a budget an action that recurses is queued
+                            // again, so the deadline is checked between calls
+                            keepAlive->r.reset(!limited && keepAlive->queued == 0);
+                            what(keepAlive->r.get_recurse());
+                        }
                     }
+                    // the posted actions that did not fit stay in posted
+                    keepAlive->return_due();
                 });
         }
 
@@ -118,20 +360,30 @@ private:
         }
 
         virtual void schedule(const rxsc::schedulable& scbl) const {
-            schedule(now(), scbl);
+            if (scbl.is_subscribed()) {
+                state->post(scbl);
+            }
         }
 
         virtual void schedule(clock_type::time_point when, const rxsc::schedulable& scbl) const {
             if (scbl.is_subscribed()) {
                 std::unique_lock<std::mutex> guard(state->lock);
-                state->queue.push(worker_state::item_type(when, scbl));
-                state->r.reset(false);
+                state->push(worker_state::item_type(when, scbl));
             }
         }
     };
 
+    update_budget budget;
+    rxsc::timer_kind::type timers;
+
 public:
-    explicit update()
+    explicit update(rxsc::timer_kind::type timers = rxsc::timer_kind::heap)
+        : timers(timers)
+    {
+    }
+    explicit update(update_budget budget, rxsc::timer_kind::type timers = rxsc::timer_kind::heap)
+        : budget(std::move(budget))
+        , timers(timers)
     {
     }
     virtual ~update()
@@ -143,7 +395,7 @@ public:
     }
 
     virtual rxsc::worker create_worker(rx::composite_subscription cs) const {
-        return rxsc::worker(cs, std::shared_ptr<worker_type>(new worker_type(cs)));
+        return rxsc::worker(cs, std::shared_ptr<worker_type>(new worker_type(cs, budget, timers)));
     }
 };
 
@@ -152,11 +404,27 @@ inline const rxsc::scheduler& make_update() {
     return us;
 }
 
+/// each worker keeps its timed actions in the selected structure.
+/// timer_kind::wheel suits many short delays and periodic timers.
+inline rxsc::scheduler make_update(rxsc::timer_kind::type timers) {
+    return rxsc::make_scheduler<update>(timers);
+}
+
+/// due actions that do not fit in the per frame budget are carried over
+/// to the next frame. the budget reports the overruns and the backlog.
+inline rxsc::scheduler make_update(update_budget budget, rxsc::timer_kind::type timers = rxsc::timer_kind::heap) {
+    return rxsc::make_scheduler<update>(std::move(budget), timers);
+}
+
 inline const rx::observe_on_one_worker& observe_on_update() {
     static auto ou = rx::observe_on_one_worker(make_update());
     return ou;
 }
 
+inline rx::observe_on_one_worker observe_on_update(update_budget budget) {
+    return rx::observe_on_one_worker(make_update(std::move(budget)));
+}
+
 inline const rx::serialize_one_worker& serialize_update() {
     static auto su = rx::serialize_one_worker(make_update());
     return su;
@@ -167,6 +435,216 @@ inline const rx::synchronize_in_one_worker& synchronize_update() {
     return su;
 }
 
+namespace detail {
+
+// the latest value is kept in one slot that the producers exchange without
+// a lock. a value put into an empty slot schedules the emitter on the
+// update worker and the emitter takes whatever is in the slot when the
+// frame runs it. the emitter stamps the frame that it emitted in, and a
+// value that arrives after that waits for the next frame, so each frame
+// emits at most one value. the box that is replaced or emitted is kept as
+// a spare for the next value.
+template<class T>
+struct sample_on_update
+{
+    typedef typename std::decay<T>::type source_value_type;
+
+    rxsc::scheduler scheduler;
+
+    explicit sample_on_update(rxsc::scheduler sc)
+        : scheduler(std::move(sc))
+    {
+    }
+
+    template<class Subscriber>
+    struct sample_on_update_observer
+    {
+        typedef sample_on_update_observer<Subscriber> this_type;
+        typedef typename std::decay<Subscriber>::type dest_type;
+        typedef rx::observer<source_value_type, this_type> observer_type;
+
+        struct sample_on_update_state
+        {
+            sample_on_update_state(dest_type d, rxsc::worker w, rx::composite_subscription cs)
+                : slot(nullptr)
+                , spare(nullptr)
+                , completed(false)
+                , emitted((std::numeric_limits<uint64_t>::max)())
+                , worker(std::move(w))
+                , lifetime(std::move(cs))
+                , dest(std::move(d))
+            {
+            }
+            ~sample_on_update_state()
+            {
+                delete slot.load();
+                delete spare.load();
+            }
+
+            // the latest value, null when it has been emitted
+            std::atomic<source_value_type*> slot;
+            std::atomic<source_value_type*> spare;
+            std::atomic<bool> completed;
+            // set before completed
+            std::exception_ptr error;
+            // the frame of the last value, only used on the main thread
+            uint64_t emitted;
+
+            rxsc::worker worker;
+            rx::composite_subscription lifetime;
+            dest_type dest;
+            rx::util::maybe<rxsc::schedulable> emitter;
+
+            void recycle(source_value_type* box) {
+                delete spare.exchange(box);
+            }
+
+            // called from any thread
+            void put(source_value_type v) {
+                auto box = spare.exchange(nullptr);
+                if (box) {
+                    *box = std::move(v);
+                } else {
+                    box = new source_value_type(std::move(v));
+                }
+                auto replaced = slot.exchange(box);
+                if (replaced) {
+                    recycle(replaced);
+                    return;
+                }
+                emitter->schedule();
+            }
+
+            // must only be called on the main thread
+            void emit() {
+                std::unique_ptr<source_value_type> box(slot.exchange(nullptr));
+                if (!box) {
+                    return;
+                }
+                emitted = ofGetFrameNum();
+                dest.on_next(std::move(*box));
+                recycle(box.release());
+            }
+
+            // must only be called on the main thread. the value stays in the
+            // slot until the next frame when this frame already emitted.
+            void tick(const rxsc::schedulable& self) {
+                if (emitted == ofGetFrameNum() && slot.load()) {
+                    self.schedule(worker.now());
+                    return;
+                }
+                emit();
+            }
+
+            // must only be called on the main thread
+            void finish() {
+                emit();
+                if (error) {
+                    dest.on_error(error);
+                } else {
+                    dest.on_completed();
+                }
+                lifetime.unsubscribe();
+            }
+        };
+        std::shared_ptr<sample_on_update_state> state;
+
+        sample_on_update_observer(dest_type d, rxsc::worker w, rx::composite_subscription cs)
+            : state(std::make_shared<sample_on_update_state>(std::move(d), std::move(w), std::move(cs)))
+        {
+        }
+
+        void on_next(source_value_type v) const {
+            if (state->completed) {
+                return;
+            }
+            state->put(std::move(v));
+        }
+        void on_error(std::exception_ptr e) const {
+            if (state->completed) {
+                return;
+            }
+            state->error = e;
+            terminate();
+        }
+        void on_completed() const {
+            if (state->completed) {
+                return;
+            }
+            terminate();
+        }
+
+        // the value in the slot is emitted before the error or completion
+        void terminate() const {
+            state->completed = true;
+            auto keepAlive = state;
+            state->worker.schedule([keepAlive](const rxsc::schedulable&){
+                keepAlive->finish();
+            });
+        }
+
+        static rx::subscriber<source_value_type, observer_type> make(dest_type d, const rxsc::scheduler& sc) {
+            // the worker runs until the destination unsubscribes, the
+            // source subscription ends when the source completes
+            auto worker = sc.create_worker(d.get_subscription());
+            auto cs = rx::composite_subscription();
+            d.add(cs);
+
+            this_type o(d, std::move(worker), cs);
+            auto state = o.state;
+
+            // the emitter refers to the state weakly so that the state is
+            // released when the destination unsubscribes
+            std::weak_ptr<sample_on_update_state> weak = state;
+            state->emitter.reset(rxsc::make_schedulable(state->worker, [weak](const rxsc::schedulable& self){
+                auto s = weak.lock();
+                if (s) {
+                    s->tick(self);
+                }
+            }));
+            d.add([state](){});
+
+            return rx::make_subscriber<source_value_type>(d, cs, observer_type(std::move(o)));
+        }
+    };
+
+    template<class Subscriber>
+    auto operator()(Subscriber dest) const
+        -> decltype(sample_on_update_observer<Subscriber>::make(std::move(dest), scheduler)) {
+        return      sample_on_update_observer<Subscriber>::make(std::move(dest), scheduler);
+    }
+};
+
+class sample_on_update_factory
+{
+    rxsc::scheduler scheduler;
+public:
+    explicit sample_on_update_factory(rxsc::scheduler sc) : scheduler(std::move(sc)) {}
+    template<class Observable>
+    auto operator()(Observable&& source)
+        -> decltype(source.template lift<typename std::decay<Observable>::type::value_type>(sample_on_update<typename std::decay<Observable>::type::value_type>(scheduler))) {
+        return      source.template lift<typename std::decay<Observable>::type::value_type>(sample_on_update<typename std::decay<Observable>::type::value_type>(scheduler));
+    }
+};
+
+}
+
+/// emits the latest value once per frame, on the main thread, when a value
+/// arrived since the last frame. use it in place of
+/// observe_on(observe_on_update()) for streams of state, like the mouse
+/// position or a download's progress, where only the newest value matters.
+///
+///     mouse.moves() | ofxRx::sample_on_update()
+///
+inline detail::sample_on_update_factory sample_on_update() {
+    return detail::sample_on_update_factory(make_update());
+}
+
+/// emits the latest value on each frame of the update scheduler sc
+inline detail::sample_on_update_factory sample_on_update(rxsc::scheduler sc) {
+    return detail::sample_on_update_factory(std::move(sc));
+}
+
 }
 
 }
\ No newline at end of file
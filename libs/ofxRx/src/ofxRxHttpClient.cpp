@@ -24,6 +24,7 @@
 
 
 #include <ofxRxHttp.h>
+#include "Poco/URI.h"
 
 
 namespace ofx {
@@ -31,11 +32,136 @@ namespace ofx {
 namespace rx {
 
 
+namespace {
+// requests with the same key can share a keep-alive session
+std::string hostKey(const HTTP::BaseRequest& request)
+{
+    Poco::URI uri(request.getURI());
+    if (uri.getHost().empty()) {
+        return request.getHost();
+    }
+    return uri.getScheme() + "://" + uri.getHost() + ":" + std::to_string(uri.getPort());
+}
+}
+
+
+namespace detail {
+
+HttpConnectionPool::HttpConnectionPool(std::size_t concurrency, rxsc::scheduler scheduler):
+    _concurrency(std::max<std::size_t>(concurrency, 1)),
+    _scheduler(std::move(scheduler)),
+    _inFlight(0),
+    sub_load(HttpLoad()),
+    dest_load(sub_load.get_subscriber().as_dynamic())
+{
+}
+
+
+void HttpConnectionPool::enqueue(const std::string& host, rx::composite_subscription lifetime, start_type start)
+{
+    {
+        std::unique_lock<std::mutex> guard(_lock);
+        waiting_type waiting = {host, std::move(lifetime), std::move(start)};
+        _waiting.push_back(std::move(waiting));
+    }
+    dispatch();
+}
+
+
+void HttpConnectionPool::release(const std::string& host, std::shared_ptr<HTTP::Context> context, bool reusable)
+{
+    {
+        std::unique_lock<std::mutex> guard(_lock);
+        --_inFlight;
+        if (reusable) {
+            _idle[host].push_back(std::move(context));
+        }
+    }
+    dispatch();
+}
+
+
+void HttpConnectionPool::dispatch()
+{
+    std::vector<std::pair<start_type, std::shared_ptr<HTTP::Context>>> ready;
+    {
+        std::unique_lock<std::mutex> guard(_lock);
+        while (_inFlight < _concurrency && !_waiting.empty()) {
+            auto next = std::move(_waiting.front());
+            _waiting.pop_front();
+            if (!next.lifetime.is_subscribed()) {
+                continue;
+            }
+            std::shared_ptr<HTTP::Context> context;
+            auto idle = _idle.find(next.host);
+            if (idle != _idle.end() && !idle->second.empty()) {
+                context = std::move(idle->second.back());
+                idle->second.pop_back();
+            } else {
+                context = std::make_shared<HTTP::Context>();
+            }
+            ++_inFlight;
+            ready.push_back(std::make_pair(std::move(next.start), std::move(context)));
+        }
+    }
+
+    publish();
+
+    for (auto& r : ready) {
+        auto start = std::move(r.first);
+        auto context = std::move(r.second);
+        // the worker is released when the request has finished
+        rx::composite_subscription cs;
+        auto worker = _scheduler.create_worker(cs);
+        worker.schedule(
+            [=](const rxsc::schedulable&){
+                start(context, cs);
+            });
+    }
+}
+
+
+void HttpConnectionPool::publish()
+{
+    std::unique_lock<std::recursive_mutex> emit(_publishLock);
+    HttpLoad current;
+    {
+        std::unique_lock<std::mutex> guard(_lock);
+        current.inFlight = _inFlight;
+        current.queued = _waiting.size();
+    }
+    dest_load.on_next(current);
+}
+
+
+rx::observable<HttpLoad> HttpConnectionPool::load() const
+{
+    return sub_load.get_observable().as_dynamic();
+}
+
+}
+
+
 HttpClient::HttpClient()
 {
 }
 
 
+HttpClient::HttpClient(std::size_t concurrency, rxsc::scheduler scheduler):
+    pool(std::make_shared<detail::HttpConnectionPool>(concurrency, std::move(scheduler)))
+{
+}
+
+
+rx::observable<HttpLoad> HttpClient::load() const
+{
+    if (!pool) {
+        return rx::observable<>::never<HttpLoad>().as_dynamic();
+    }
+    return pool->load();
+}
+
+
 rx::observable<HttpProgress> HttpClient::get(const std::string& uri,
                                        const Poco::Net::NameValueCollection& formFields,
                                        const std::string& httpVersion,
@@ -65,6 +191,60 @@ rx::observable<HttpProgress> HttpClient::post(const std::string& uri,
 rx::observable<HttpProgress> HttpClient::request(HTTP::BaseRequest* pRequest)
 {
     std::shared_ptr<HTTP::BaseRequest> request(pRequest);
+    if (pool) {
+        auto p = pool;
+        return rx::observable<>::create<HttpProgress>(
+            [=](rx::subscriber<HttpProgress> dest){
+                std::string host;
+                try {
+                    host = hostKey(*request);
+                } catch(...) {
+                    dest.on_error(std::current_exception());
+                    return;
+                }
+                p->enqueue(host, dest.get_subscription(),
+                    [=](std::shared_ptr<HTTP::Context> context, rx::composite_subscription worker){
+                        // the slot and the worker are released once, when
+                        // the body ends or when the request throws first
+                        auto released = std::make_shared<std::atomic<bool>>(false);
+                        auto finish = [=](bool reusable){
+                            if (!released->exchange(true)) {
+                                p->release(host, context, reusable);
+                                worker.unsubscribe();
+                            }
+                        };
+                        if (!dest.is_subscribed()) {
+                            finish(true);
+                            return;
+                        }
+                        bool submitted = false;
+                        RXCPP_UNWIND_AUTO([&](){
+                            if (!submitted) {
+                                finish(false);
+                            }
+                        });
+                        HttpProgress progress(request,
+                            new HTTP::BaseResponse(),
+                            context);
+                        // the body is read by actions that submit queues on
+                        // this worker. a session with unread bytes in its
+                        // stream is not reused.
+                        progress.body().subscribe(
+                            worker,
+                            [](const HttpChunk&){},
+                            [=](std::exception_ptr){
+                                finish(false);
+                            },
+                            [=](){
+                                finish(progress.complete() && !progress.failed());
+                            });
+                        dest.on_next(progress);
+                        dest.on_completed();
+                        progress.submit();
+                        submitted = true;
+                    });
+            }).as_dynamic();
+    }
     return rx::observable<>::defer(
         [=](){
             HttpProgress progress(request,
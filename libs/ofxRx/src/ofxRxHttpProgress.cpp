@@ -29,15 +29,72 @@ namespace ofx {
 
 namespace rx {
 
+std::shared_ptr<Poco::MemoryPool> http_buffer_pool()
+{
+    static auto pool = std::make_shared<Poco::MemoryPool>(
+        IO::ByteBufferUtils::DEFAULT_BUFFER_SIZE + BufferRef<char>::overhead_size);
+    return pool;
+}
+
+
+namespace {
+struct collected
+{
+    collected()
+        : filled(0)
+    {
+    }
+    std::shared_ptr<ofBuffer> buffer;
+    size_t filled;
+};
+}
+
+
+rx::observable<std::shared_ptr<ofBuffer>> HttpProgress::collect() const
+{
+    return body().
+        reduce(
+            collected(),
+            [](collected& acc, HttpChunk chunk){
+                if (!acc.buffer) {
+                    acc.buffer = std::make_shared<ofBuffer>();
+                    auto length = chunk.getResponse().getContentLength();
+                    if (length > 0) {
+                        acc.buffer->allocate(length);
+                    }
+                }
+                // bytes past the Content-Length are appended
+                auto fits = std::min<size_t>(chunk.size(), acc.buffer->size() - acc.filled);
+                std::copy(chunk.begin(), chunk.begin() + fits, acc.buffer->getBinaryBuffer() + acc.filled);
+                if (fits < chunk.size()) {
+                    acc.buffer->append(chunk.begin() + fits, chunk.size() - fits);
+                }
+                acc.filled += chunk.size();
+            },
+            [](collected acc) -> std::shared_ptr<ofBuffer> {
+                if (!acc.buffer) {
+                    return std::make_shared<ofBuffer>();
+                }
+                if (acc.filled < acc.buffer->size()) {
+                    // shorter than the Content-Length
+                    return std::make_shared<ofBuffer>(acc.buffer->getBinaryBuffer(), acc.filled);
+                }
+                return acc.buffer;
+            }).
+        as_dynamic();
+}
+
+
 namespace detail {
 HttpProgressState::HttpProgressState(std::shared_ptr<HTTP::BaseRequest> request,
                     HTTP::BaseResponse* response,
-                    HTTP::Context* context):
+                    std::shared_ptr<HTTP::Context> context):
     DefaultClient(),
     _request(request),
     _response(response),
-    _context(context),
-    pool(std::make_shared<Poco::MemoryPool>(bufferSize + BufferRef<char>::overhead_size)),
+    _context(std::move(context)),
+    _failed(false),
+    _complete(false),
     dest_request(sub_request.get_subscriber().as_dynamic()),
     dest_response(sub_response.get_subscriber().as_dynamic()),
     dest_body(sub_body.get_subscriber().as_dynamic())
@@ -48,7 +105,6 @@ HttpProgressState::HttpProgressState(std::shared_ptr<HTTP::BaseRequest> request,
 HttpProgressState::~HttpProgressState()
 {
     delete _response;
-    delete _context;
 }
 
 
@@ -70,9 +126,9 @@ bool HttpProgressState::onHTTPClientResponseEvent(HTTP::ClientResponseEventArgs&
     w.schedule([=](const rx::schedulers::schedulable& self){
         std::istream& istr = args.getResponseStream();
 
-        auto buffy = BufferRef<char>(keep->pool, keep->bufferSize + BufferRef<char>::overhead_size, args);
+        auto buffy = HttpChunk(BufferRef<char>::from_pool(http_buffer_pool()), args);
         std::streamsize len = 0;
-        istr.read(buffy.begin(), keep->bufferSize);
+        istr.read(buffy.begin(), buffy.size());
         std::streamsize n = istr.gcount();
 
         if (n > 0) {
@@ -90,13 +146,16 @@ bool HttpProgressState::onHTTPClientResponseEvent(HTTP::ClientResponseEventArgs&
             }
 
             if (!istr.good()) {
+                keep->_failed = true;
                 std::runtime_error error("istream !good()");
-                rx::observable<>::error<BufferRef<char>>(error).subscribe(dest_body);
+                rx::observable<>::error<HttpChunk>(error).subscribe(dest_body);
             }
         }
 
         // finished
 
+        keep->_complete = istr.eof();
+
         unregisterClientFilterEvents(keep.get());
         unregisterClientProgressEvents(keep.get());
         unregisterClientEvents(keep.get());
@@ -112,6 +171,7 @@ bool HttpProgressState::onHTTPClientResponseEvent(HTTP::ClientResponseEventArgs&
 
 bool HttpProgressState::onHTTPClientErrorEvent(HTTP::ClientErrorEventArgs& args)
 {
+    _failed = true;
     try {
         throw args.getException();
     } catch(...) {
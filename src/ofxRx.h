@@ -393,6 +393,8 @@ namespace rxsc=rxcpp::rxsc;
 
 namespace ofxRx = ofx::rx;
 
+#include "ofxRxBufferRef.h"
+#include "ofxRxChunked.h"
 #include "ofxRxObservableFrom.h"
 #include "ofxRxMouse.h"
 #include "ofxRxKeyboard.h"
@@ -0,0 +1,146 @@
+// the allocations and the time per operation of BufferRef: taking blocks
+// from a pool and from the heap, copying and slicing views on one thread
+// and copying one view from several threads.
+
+#include "ofxRxTest.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <numeric>
+
+using std::chrono::steady_clock;
+
+namespace {
+
+std::atomic<long> allocations(0);
+
+// a pool with the interface of Poco::MemoryPool that keeps released blocks
+struct free_list_pool
+{
+    explicit free_list_pool(size_t size)
+        : block(size)
+    {
+    }
+    ~free_list_pool()
+    {
+        for (auto p : blocks) {
+            ::operator delete(p);
+        }
+    }
+    size_t blockSize() const {
+        return block;
+    }
+    void* get() {
+        std::unique_lock<std::mutex> guard(lock);
+        if (blocks.empty()) {
+            return ::operator new(block);
+        }
+        auto p = blocks.back();
+        blocks.pop_back();
+        return p;
+    }
+    void release(void* p) {
+        std::unique_lock<std::mutex> guard(lock);
+        blocks.push_back(p);
+    }
+    size_t block;
+    std::mutex lock;
+    std::vector<void*> blocks;
+};
+
+template<class F>
+void measure(const char* name, long count, F f)
+{
+    long before = allocations;
+    auto start = steady_clock::now();
+    f(count);
+    double seconds = std::chrono::duration<double>(steady_clock::now() - start).count();
+    long allocated = allocations - before;
+    std::printf("%-28s %8.1f ns/op %8.3f allocations/op\n",
+        name, seconds * 1e9 / count, static_cast<double>(allocated) / count);
+}
+
+}
+
+void* operator new(std::size_t size)
+{
+    ++allocations;
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+int main()
+{
+    const long count = 10000000;
+    typedef ofxRx::BufferRef<char> buffer;
+
+    auto pool = std::make_shared<free_list_pool>(4096);
+    // warm the pool so that the loop reuses one block
+    buffer::from_pool(pool);
+
+    volatile char sink = 0;
+
+    measure("from_pool and release", count, [&](long n){
+        for (long i = 0; i < n; ++i) {
+            auto b = buffer::from_pool(pool);
+            sink = b.begin()[0];
+        }
+    });
+    measure("allocate and release", count, [&](long n){
+        for (long i = 0; i < n; ++i) {
+            auto b = buffer::allocate(4096);
+            sink = b.begin()[0];
+        }
+    });
+
+    auto b = buffer::from_pool(pool);
+    std::fill(b.begin(), b.end(), 1);
+
+    measure("copy", count, [&](long n){
+        for (long i = 0; i < n; ++i) {
+            auto c = b;
+            sink = c.begin()[0];
+        }
+    });
+    measure("slice", count, [&](long n){
+        for (long i = 0; i < n; ++i) {
+            auto s = b.slice(i & 1023, 64);
+            sink = s.begin()[0];
+        }
+    });
+    measure("sum of 4096 bytes", count / 1000, [&](long n){
+        long total = 0;
+        for (long i = 0; i < n; ++i) {
+            total += std::accumulate(b.begin(), b.end(), 0L);
+        }
+        sink = static_cast<char>(total);
+    });
+
+    for (int threads : {2, 4, 8}) {
+        char name[64];
+        std::snprintf(name, sizeof(name), "copy on %d threads", threads);
+        measure(name, count, [&](long n){
+            std::vector<std::thread> workers;
+            for (int t = 0; t < threads; ++t) {
+                workers.emplace_back([&, t](){
+                    for (long i = t; i < n; i += threads) {
+                        auto c = b;
+                        sink = c.begin()[0];
+                    }
+                });
+            }
+            for (auto& w : workers) {
+                w.join();
+            }
+        });
+    }
+    return static_cast<int>(sink) - 1;
+}
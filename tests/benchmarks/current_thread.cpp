@@ -0,0 +1,129 @@
+// the time and the allocations per step of synchronous recursion on the
+// current_thread scheduler: one deep trampoline that runs every step
+// through its queue, many short trampolines that each take the thread's
+// spare queue, and operators that nest trampolines.
+
+#include <rxcpp/rx.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+namespace rx=rxcpp;
+namespace rxsc=rxcpp::schedulers;
+
+using std::chrono::steady_clock;
+
+namespace {
+
+std::atomic<long> allocations(0);
+
+// the best of five runs of count calls to f
+template<class F>
+void measure(const char* name, long count, long steps, F f)
+{
+    f();
+    double best = 0;
+    double allocated = 0;
+    for (int run = 0; run < 5; ++run) {
+        long before = allocations;
+        auto start = steady_clock::now();
+        for (long i = 0; i < count; ++i) {
+            f();
+        }
+        double ns = std::chrono::duration<double, std::nano>(steady_clock::now() - start).count() / (count * steps);
+        if (run == 0 || ns < best) {
+            best = ns;
+        }
+        allocated = static_cast<double>(allocations - before) / (count * steps);
+    }
+    std::printf("%-36s %8.1f ns/step %8.2f allocations/step\n", name, best, allocated);
+}
+
+}
+
+void* operator new(std::size_t size)
+{
+    ++allocations;
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+int main()
+{
+    auto ct = rxsc::make_current_thread();
+    const long depth = 100000;
+
+    // each action schedules the next one with self, so every step goes
+    // through the queue of one trampoline
+    measure("self recursion 100k deep", 20, depth, [&](){
+        auto w = ct.create_worker();
+        long left = depth;
+        w.schedule([&](const rxsc::schedulable& self){
+            if (--left > 0) {
+                self.schedule();
+            }
+        });
+        if (left != 0) {
+            std::abort();
+        }
+    });
+
+    // each action schedules a new action on the worker
+    measure("nested schedule 100k deep", 20, depth, [&](){
+        auto w = ct.create_worker();
+        long left = depth;
+        std::function<void(const rxsc::schedulable&)> step;
+        step = [&](const rxsc::schedulable&){
+            if (--left > 0) {
+                w.schedule(step);
+            }
+        };
+        w.schedule(step);
+        if (left != 0) {
+            std::abort();
+        }
+    });
+
+    // one action queues all of the steps before any of them runs
+    measure("100k actions queued at once", 20, depth, [&](){
+        auto w = ct.create_worker();
+        long ran = 0;
+        auto leaf = rxsc::make_schedulable(w, [&](const rxsc::schedulable&){
+            ++ran;
+        });
+        w.schedule([&](const rxsc::schedulable&){
+            for (long i = 0; i < depth; ++i) {
+                w.schedule(leaf);
+            }
+        });
+        if (ran != depth) {
+            std::abort();
+        }
+    });
+
+    // each subscribe starts and ends one trampoline
+    measure("short trampolines", 200000, 1, [&](){
+        long sum = 0;
+        rx::observable<>::just(1).subscribe([&](int v){ sum += v; });
+    });
+
+    // the inner subscriptions join the trampoline of the outer one
+    measure("nested concat_map trampolines", 2000, 1, [&](){
+        long sum = 0;
+        rx::observable<>::range(1, 10).
+            concat_map(
+                [](int v){ return rx::observable<>::range(1, v); },
+                [](int, int v){ return v; }).
+            subscribe([&](int v){ sum += v; });
+    });
+
+    return 0;
+}
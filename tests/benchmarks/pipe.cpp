@@ -0,0 +1,88 @@
+// the time per value of a chain of synchronous operators, applied as one
+// pipe() and as one lift per operator. the values come from a subject, so
+// each one passes through the whole chain.
+
+#include <rxcpp/rx.hpp>
+
+#include <cstdio>
+#include <string>
+
+namespace rx=rxcpp;
+namespace rxo=rxcpp::operators;
+
+using std::chrono::steady_clock;
+
+namespace {
+
+template<class Observable, class F>
+double per_value(long count, Observable values, rx::subjects::subject<int> source, F f)
+{
+    auto lifetime = values.subscribe(f);
+    auto in = source.get_subscriber();
+    auto start = steady_clock::now();
+    for (long i = 0; i < count; ++i) {
+        in.on_next(static_cast<int>(i));
+    }
+    double seconds = std::chrono::duration<double>(steady_clock::now() - start).count();
+    lifetime.unsubscribe();
+    return seconds * 1e9 / count;
+}
+
+void report(const char* name, double chained, double piped)
+{
+    std::printf("%-36s chain %7.1f ns/value  pipe %7.1f ns/value  %5.2fx\n",
+        name, chained, piped, chained / piped);
+}
+
+}
+
+int main()
+{
+    const long count = 5000000;
+    long long sink = 0;
+
+    for (int run = 0; run < 3; ++run) {
+        rx::subjects::subject<int> s1, s2;
+        auto chained = per_value(count,
+            s1.get_observable().
+                map([](int v){ return v * 3; }).
+                filter([](int v){ return v % 2 == 0; }).
+                map([](int v){ return v / 4; }).
+                distinct_until_changed().
+                skip(1),
+            s1, [&](int v){ sink += v; });
+        auto piped = per_value(count,
+            s2.get_observable() |
+                rxo::pipe().
+                map([](int v){ return v * 3; }).
+                filter([](int v){ return v % 2 == 0; }).
+                map([](int v){ return v / 4; }).
+                distinct_until_changed().
+                skip(1),
+            s2, [&](int v){ sink += v; });
+        report("int map filter map distinct skip", chained, piped);
+    }
+
+    for (int run = 0; run < 3; ++run) {
+        rx::subjects::subject<int> s1, s2;
+        auto chained = per_value(count / 5,
+            s1.get_observable().
+                map([](int v){ return std::to_string(v); }).
+                filter([](const std::string& v){ return v.back() != '3'; }).
+                map([](std::string v){ return v + "x"; }).
+                distinct_until_changed(),
+            s1, [&](const std::string& v){ sink += v.size(); });
+        auto piped = per_value(count / 5,
+            s2.get_observable() |
+                rxo::pipe().
+                map([](int v){ return std::to_string(v); }).
+                filter([](const std::string& v){ return v.back() != '3'; }).
+                map([](std::string v){ return v + "x"; }).
+                distinct_until_changed(),
+            s2, [&](const std::string& v){ sink += v.size(); });
+        report("string map filter map distinct", chained, piped);
+    }
+
+    std::printf("%lld\n", sink);
+    return 0;
+}
@@ -0,0 +1,86 @@
+// posts immediate actions to an update worker from N producer threads while
+// the main thread sends frames as fast as it can. the time per action stays
+// flat as producers are added when posting does not contend.
+
+#include "ofxRxTest.h"
+
+#include <cstdio>
+
+namespace rxsc=rxcpp::schedulers;
+
+using std::chrono::steady_clock;
+
+namespace {
+
+const int per_producer = 200000;
+
+struct result
+{
+    double seconds;
+    long frames;
+};
+
+// starts the producer threads, they post together once go is set
+template<class Post>
+std::vector<std::thread> start_producers(int producers, std::atomic<bool>& go, Post post)
+{
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&go, post](){
+            while (!go) {
+                std::this_thread::yield();
+            }
+            for (int i = 0; i < per_producer; ++i) {
+                post();
+            }
+        });
+    }
+    return threads;
+}
+
+result run_update(int producers)
+{
+    auto w = ofxRx::make_update().create_worker();
+    long total = static_cast<long>(producers) * per_producer;
+    long ran = 0;
+    std::atomic<bool> go(false);
+    rxsc::schedulable action = rxsc::make_schedulable(w, [&](const rxsc::schedulable&){
+        ++ran;
+    });
+
+    auto threads = start_producers(producers, go, [&](){
+        action.schedule();
+    });
+
+    result r = {0, 0};
+    auto start = steady_clock::now();
+    go = true;
+    while (ran < total) {
+        ofxRxTest::frame();
+        ++r.frames;
+    }
+    r.seconds = std::chrono::duration<double>(steady_clock::now() - start).count();
+    for (auto& t : threads) {
+        t.join();
+    }
+    w.unsubscribe();
+    return r;
+}
+
+void report(const char* name, int producers, result r)
+{
+    double actions = static_cast<double>(producers) * per_producer;
+    std::printf("%-8s %2d producers: %8.1f ns/action %8.2f Mactions/s %8ld frames\n",
+        name, producers, r.seconds * 1e9 / actions, actions / r.seconds / 1e6, r.frames);
+}
+
+}
+
+int main()
+{
+    std::printf("%d actions per producer\n", per_producer);
+    for (int producers : {1, 2, 4, 8}) {
+        report("update", producers, run_update(producers));
+    }
+    return 0;
+}
@@ -0,0 +1,164 @@
+#include "ofxRxTest.h"
+#include <catch2/catch.hpp>
+
+#include <numeric>
+
+namespace {
+
+// a pool with the interface of Poco::MemoryPool that counts its blocks
+struct counting_pool
+{
+    explicit counting_pool(size_t size)
+        : block(size)
+        , gets(0)
+        , releases(0)
+    {
+    }
+    size_t blockSize() const {
+        return block;
+    }
+    void* get() {
+        ++gets;
+        return ::operator new(block);
+    }
+    void release(void* p) {
+        ++releases;
+        ::operator delete(p);
+    }
+    size_t block;
+    std::atomic<int> gets;
+    std::atomic<int> releases;
+};
+
+}
+
+SCENARIO("BufferRef views share one block", "[BufferRef]"){
+    GIVEN("a block of 16 ints from the heap"){
+        auto b = ofxRx::BufferRef<int>::allocate(16);
+        std::iota(b.begin(), b.end(), 0);
+
+        THEN("it holds 16 elements and one view"){
+            REQUIRE(b.size() == 16);
+            REQUIRE_FALSE(b.empty());
+            REQUIRE(b.use_count() == 1);
+        }
+        WHEN("it is copied"){
+            auto c = b;
+            THEN("the copy sees the same elements and the count is shared"){
+                REQUIRE(c.data() == b.data());
+                REQUIRE(b.use_count() == 2);
+                c.begin()[3] = 42;
+                REQUIRE(b.begin()[3] == 42);
+            }
+        }
+        WHEN("it is moved"){
+            auto m = std::move(b);
+            THEN("the source is empty and the count did not change"){
+                REQUIRE(b.empty());
+                REQUIRE(b.use_count() == 0);
+                REQUIRE(m.use_count() == 1);
+                REQUIRE(m.size() == 16);
+            }
+        }
+        WHEN("it is sliced"){
+            auto s = b.slice(4, 8);
+            THEN("the slice starts at the offset and shares the block"){
+                REQUIRE(s.size() == 8);
+                REQUIRE(s.begin()[0] == 4);
+                REQUIRE(s.end()[-1] == 11);
+                REQUIRE(b.use_count() == 2);
+            }
+        }
+        WHEN("it is resized"){
+            b.resize(5);
+            THEN("the view is shorter and the elements are kept"){
+                REQUIRE(b.size() == 5);
+                REQUIRE(b.end()[-1] == 4);
+            }
+        }
+        WHEN("it is assigned to itself"){
+            auto& self = b;
+            b = self;
+            THEN("the view and the count are unchanged"){
+                REQUIRE(b.size() == 16);
+                REQUIRE(b.use_count() == 1);
+                REQUIRE(b.begin()[15] == 15);
+            }
+        }
+        WHEN("it is assigned another view"){
+            auto other = ofxRx::BufferRef<int>::allocate(2);
+            auto keep = other;
+            b = other;
+            THEN("it shares the other block"){
+                REQUIRE(b.data() == other.data());
+                REQUIRE(other.use_count() == 3);
+            }
+        }
+    }
+}
+
+SCENARIO("BufferRef returns pooled blocks once, after the last view", "[BufferRef]"){
+    GIVEN("a pool of 64 byte blocks"){
+        auto pool = std::make_shared<counting_pool>(64);
+
+        WHEN("a block is taken and the views are released"){
+            auto b = ofxRx::BufferRef<char>::from_pool(pool);
+            auto s = b.slice(1, 2);
+
+            THEN("the view covers the block after the refcount"){
+                REQUIRE(b.size() == 64 - ofxRx::BufferRef<char>::overhead_size);
+                REQUIRE(pool->gets == 1);
+            }
+
+            b = ofxRx::BufferRef<char>();
+            THEN("a slice keeps the block"){
+                REQUIRE(pool->releases == 0);
+                REQUIRE(s.use_count() == 1);
+            }
+
+            s = ofxRx::BufferRef<char>();
+            THEN("the last view returns it"){
+                REQUIRE(pool->releases == 1);
+            }
+        }
+        WHEN("the last owner of the pool goes away first"){
+            std::weak_ptr<counting_pool> weak = pool;
+            auto b = ofxRx::BufferRef<char>::from_pool(std::move(pool));
+
+            THEN("the block keeps the pool until the block is returned"){
+                REQUIRE_FALSE(weak.expired());
+                b = ofxRx::BufferRef<char>();
+                REQUIRE(weak.expired());
+            }
+        }
+    }
+}
+
+SCENARIO("BufferRef copies from several threads", "[BufferRef]"){
+    GIVEN("a pooled block shared by four threads"){
+        auto pool = std::make_shared<counting_pool>(128);
+        auto b = ofxRx::BufferRef<char>::from_pool(pool);
+
+        WHEN("each thread copies and drops the view many times"){
+            std::vector<std::thread> threads;
+            for (int t = 0; t < 4; ++t) {
+                threads.emplace_back([b](){
+                    for (int i = 0; i < 100000; ++i) {
+                        auto c = b;
+                        auto s = c.slice(0, 1);
+                    }
+                });
+            }
+            for (auto& t : threads) {
+                t.join();
+            }
+
+            THEN("the count is back to one and the block is returned once"){
+                REQUIRE(b.use_count() == 1);
+                REQUIRE(pool->releases == 0);
+                b = ofxRx::BufferRef<char>();
+                REQUIRE(pool->releases == 1);
+            }
+        }
+    }
+}
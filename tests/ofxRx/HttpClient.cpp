@@ -0,0 +1,117 @@
+#include "ofxRxHttp.h"
+#include <catch2/catch.hpp>
+
+#include "Poco/Net/HTTPServer.h"
+#include "Poco/Net/HTTPRequestHandler.h"
+#include "Poco/Net/HTTPRequestHandlerFactory.h"
+#include "Poco/Net/HTTPServerParams.h"
+#include "Poco/Net/HTTPServerRequest.h"
+#include "Poco/Net/HTTPServerResponse.h"
+#include "Poco/Net/ServerSocket.h"
+
+namespace {
+
+const std::size_t body_size = 20000;
+
+class fixed_body : public Poco::Net::HTTPRequestHandler
+{
+public:
+    void handleRequest(Poco::Net::HTTPServerRequest&, Poco::Net::HTTPServerResponse& response) {
+        response.setKeepAlive(true);
+        response.setContentLength(body_size);
+        response.send() << std::string(body_size, 'x');
+    }
+};
+
+class fixed_body_factory : public Poco::Net::HTTPRequestHandlerFactory
+{
+public:
+    Poco::Net::HTTPRequestHandler* createRequestHandler(const Poco::Net::HTTPServerRequest&) {
+        return new fixed_body();
+    }
+};
+
+// a keep-alive server on a free loopback port
+struct loopback
+{
+    loopback()
+        : socket(Poco::Net::SocketAddress("127.0.0.1", 0))
+        , server(new fixed_body_factory(), socket, params())
+    {
+        server.start();
+    }
+    ~loopback() {
+        server.stop();
+    }
+    static Poco::Net::HTTPServerParams::Ptr params() {
+        Poco::Net::HTTPServerParams::Ptr p(new Poco::Net::HTTPServerParams());
+        p->setKeepAlive(true);
+        p->setMaxKeepAliveRequests(1000);
+        return p;
+    }
+    std::string uri() const {
+        return "http://127.0.0.1:" + std::to_string(socket.address().port()) + "/";
+    }
+    Poco::Net::ServerSocket socket;
+    Poco::Net::HTTPServer server;
+};
+
+}
+
+SCENARIO("a pooled HttpClient reuses its connections to a host", "[http][pool]"){
+    GIVEN("a loopback server and a client with two connections"){
+        loopback server;
+        ofxRx::HttpClient client(2);
+        const int requests = 50;
+
+        std::vector<ofxRx::HttpLoad> loads;
+        std::mutex loadsLock;
+        auto loadSubscription = client.load().subscribe([&](ofxRx::HttpLoad l){
+            std::unique_lock<std::mutex> guard(loadsLock);
+            loads.push_back(l);
+        });
+
+        WHEN("the requests are subscribed at once"){
+            std::atomic<std::size_t> bytes(0);
+            std::atomic<int> done(0);
+            std::atomic<int> errors(0);
+            for (int i = 0; i < requests; ++i) {
+                client.get(server.uri()).
+                    subscribe([&](ofxRx::HttpProgress progress){
+                        progress.body().subscribe(
+                            [&](const ofxRx::HttpChunk& chunk){
+                                bytes += chunk.size();
+                            },
+                            [&](std::exception_ptr){
+                                ++errors;
+                                ++done;
+                            },
+                            [&](){
+                                ++done;
+                            });
+                    });
+            }
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+            while (done < requests && std::chrono::steady_clock::now() < deadline) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+
+            THEN("every body is read and at most two sockets were opened"){
+                REQUIRE(done == requests);
+                REQUIRE(errors == 0);
+                REQUIRE(bytes == requests * body_size);
+                REQUIRE(server.server.totalConnections() <= 2);
+            }
+            THEN("no more than two requests were in flight and the counts return to zero"){
+                std::unique_lock<std::mutex> guard(loadsLock);
+                REQUIRE(!loads.empty());
+                for (auto& l : loads) {
+                    REQUIRE(l.inFlight <= 2);
+                }
+                REQUIRE(loads.back().inFlight == 0);
+                REQUIRE(loads.back().queued == 0);
+            }
+        }
+        loadSubscription.unsubscribe();
+    }
+}
@@ -0,0 +1,51 @@
+#include "ofxRxTest.h"
+#include <catch2/catch.hpp>
+
+namespace rx=rxcpp;
+
+SCENARIO("sample_on_update emits at most one value per frame", "[sample_on_update][update]"){
+    GIVEN("a budgeted update scheduler and a subject"){
+        auto sc = ofxRx::make_update(ofxRx::update_budget(std::chrono::milliseconds(10)));
+        rx::subjects::subject<int> source;
+        auto in = source.get_subscriber();
+        std::vector<std::pair<uint64_t, int>> emitted;
+
+        WHEN("a value arrives in the frame after the emitter ran"){
+            auto lifetime = (source.get_observable() | ofxRx::sample_on_update(sc)).
+                subscribe([&](int v){
+                    emitted.push_back(std::make_pair(ofGetFrameNum(), v));
+                    if (v == 1) {
+                        in.on_next(2);
+                    }
+                });
+            in.on_next(1);
+            ofxRxTest::frame();
+            auto first = ofGetFrameNum();
+            ofxRxTest::frame();
+
+            THEN("the value is emitted in the next frame"){
+                REQUIRE(emitted.size() == 2);
+                REQUIRE(emitted[0] == std::make_pair(first, 1));
+                REQUIRE(emitted[1] == std::make_pair(first + 1, 2));
+            }
+            lifetime.unsubscribe();
+        }
+        WHEN("several values arrive between frames"){
+            auto lifetime = (source.get_observable() | ofxRx::sample_on_update(sc)).
+                subscribe([&](int v){
+                    emitted.push_back(std::make_pair(ofGetFrameNum(), v));
+                });
+            in.on_next(1);
+            in.on_next(2);
+            in.on_next(3);
+            ofxRxTest::frame();
+            ofxRxTest::frame();
+
+            THEN("only the latest is emitted"){
+                REQUIRE(emitted.size() == 1);
+                REQUIRE(emitted[0].second == 3);
+            }
+            lifetime.unsubscribe();
+        }
+    }
+}
@@ -0,0 +1,115 @@
+#include "ofxRxTest.h"
+#include <catch2/catch.hpp>
+
+namespace rxsc=rxcpp::schedulers;
+
+SCENARIO("update runs the posted actions on the thread that sends the frames", "[update][scheduler]"){
+    GIVEN("producers that post to one update worker"){
+        auto w = ofxRx::make_update().create_worker();
+        const int producers = 4;
+        const int count = 10000;
+        std::vector<std::vector<int>> received(producers);
+        auto main = std::this_thread::get_id();
+        std::atomic<bool> off_main(false);
+
+        WHEN("each producer posts its values in order"){
+            std::vector<std::thread> threads;
+            for (int p = 0; p < producers; ++p) {
+                threads.emplace_back([&, p](){
+                    for (int i = 0; i < count; ++i) {
+                        w.schedule([&, p, i](const rxsc::schedulable&){
+                            if (std::this_thread::get_id() != main) {
+                                off_main = true;
+                            }
+                            received[p].push_back(i);
+                        });
+                    }
+                });
+            }
+            for (auto& t : threads) {
+                t.join();
+            }
+            ofxRxTest::frame();
+
+            THEN("every action ran on the main thread in the order of its producer"){
+                REQUIRE_FALSE(off_main);
+                for (auto& values : received) {
+                    REQUIRE(values.size() == static_cast<size_t>(count));
+                    REQUIRE(std::is_sorted(values.begin(), values.end()));
+                }
+            }
+        }
+        w.unsubscribe();
+    }
+}
+
+SCENARIO("update runs the actions scheduled during a frame in that frame", "[update][scheduler]"){
+    GIVEN("an update worker without a budget"){
+        auto w = ofxRx::make_update().create_worker();
+        std::vector<std::string> ran;
+
+        WHEN("an action schedules another action"){
+            w.schedule([&](const rxsc::schedulable&){
+                ran.push_back("outer");
+                w.schedule([&](const rxsc::schedulable&){
+                    ran.push_back("inner");
+                });
+            });
+            ofxRxTest::frame();
+
+            THEN("both ran in one frame"){
+                REQUIRE(ran == std::vector<std::string>({"outer", "inner"}));
+            }
+        }
+        w.unsubscribe();
+    }
+}
+
+SCENARIO("update runs posted and timed actions in the order of their times", "[update][scheduler]"){
+    GIVEN("an update worker"){
+        auto w = ofxRx::make_update().create_worker();
+        std::vector<int> ran;
+
+        WHEN("a timed action is due before a posted one"){
+            w.schedule(w.now() - std::chrono::milliseconds(1), [&](const rxsc::schedulable&){
+                ran.push_back(1);
+            });
+            w.schedule([&](const rxsc::schedulable&){
+                ran.push_back(2);
+            });
+            w.schedule(w.now() + std::chrono::hours(1), [&](const rxsc::schedulable&){
+                ran.push_back(3);
+            });
+            ofxRxTest::frame();
+
+            THEN("the due actions ran in time order and the future one waits"){
+                REQUIRE(ran == std::vector<int>({1, 2}));
+            }
+        }
+        w.unsubscribe();
+    }
+}
+
+SCENARIO("update runs a timed action that is due during a frame in the next frame", "[update][scheduler]"){
+    GIVEN("an update worker"){
+        auto w = ofxRx::make_update().create_worker();
+        std::vector<uint64_t> ran;
+
+        WHEN("an action schedules another for now"){
+            w.schedule([&](const rxsc::schedulable&){
+                ran.push_back(ofGetFrameNum());
+                w.schedule(w.now(), [&](const rxsc::schedulable&){
+                    ran.push_back(ofGetFrameNum());
+                });
+            });
+            ofxRxTest::frame();
+            ofxRxTest::frame();
+
+            THEN("the timed action waited for the next frame"){
+                REQUIRE(ran.size() == 2);
+                REQUIRE(ran[1] == ran[0] + 1);
+            }
+        }
+        w.unsubscribe();
+    }
+}
@@ -0,0 +1,50 @@
+#include <rxcpp/rx.hpp>
+#include <catch2/catch.hpp>
+
+namespace rx=rxcpp;
+
+namespace {
+
+struct small_counter
+{
+    int count = 0;
+};
+
+struct large_counter
+{
+    int count = 0;
+    char padding[RXCPP_INLINE_ERASED_SIZE];
+};
+
+}
+
+SCENARIO("inline_erased copies small objects and shares large ones", "[inline_erased][util]"){
+    GIVEN("an erased object that fits inline"){
+        rx::util::detail::inline_erased<> held;
+        held.emplace<small_counter>(small_counter());
+
+        WHEN("it is copied and the copy is changed"){
+            auto copy = held;
+            static_cast<small_counter*>(copy.get())->count = 1;
+
+            THEN("the original is unchanged"){
+                REQUIRE(static_cast<small_counter*>(held.get())->count == 0);
+                REQUIRE(held.get() != copy.get());
+            }
+        }
+    }
+    GIVEN("an erased object that is too large to be inline"){
+        rx::util::detail::inline_erased<> held;
+        held.emplace<large_counter>(large_counter());
+
+        WHEN("it is copied and the copy is changed"){
+            auto copy = held;
+            static_cast<large_counter*>(copy.get())->count = 1;
+
+            THEN("the original is the same object"){
+                REQUIRE(static_cast<large_counter*>(held.get())->count == 1);
+                REQUIRE(held.get() == copy.get());
+            }
+        }
+    }
+}
@@ -0,0 +1,64 @@
+#include <rxcpp/rx.hpp>
+#include <catch2/catch.hpp>
+
+namespace rx=rxcpp;
+namespace rxsc=rxcpp::schedulers;
+
+SCENARIO("group_by_hashed completes idle groups while the source is quiet", "[group_by_hashed][operators]"){
+    GIVEN("a subject and an idle duration of 20ms"){
+        rx::subjects::subject<int> source;
+        auto eviction = rx::group_by_eviction(std::chrono::milliseconds(20));
+        rx::group_by_counters counters;
+        std::atomic<int> completed(0);
+        std::atomic<int> values(0);
+
+        auto subscribe_groups = [&](rx::observable<rx::grouped_observable<int, int>> groups){
+            return groups.subscribe([&](rx::grouped_observable<int, int> g){
+                g.subscribe(
+                    [&](int){ ++values; },
+                    [&](){ ++completed; });
+            });
+        };
+
+        WHEN("the groups are timed on an event loop and the source emits two keys once"){
+            auto lifetime = subscribe_groups(source.get_observable().
+                group_by_hashed([](int v){ return v % 2; }, [](int v){ return v; }, eviction,
+                    rx::identity_one_worker(rxsc::make_event_loop()), counters));
+            source.get_subscriber().on_next(1);
+            source.get_subscriber().on_next(2);
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+            while (completed < 2 && std::chrono::steady_clock::now() < deadline) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            }
+
+            THEN("both groups are completed without another value"){
+                REQUIRE(values == 2);
+                REQUIRE(completed == 2);
+                REQUIRE(counters.evicted() == 2);
+                REQUIRE(counters.active() == 0);
+            }
+            WHEN("the key is seen again"){
+                source.get_subscriber().on_next(3);
+
+                THEN("a new group is started"){
+                    REQUIRE(counters.created() == 3);
+                    REQUIRE(values == 3);
+                }
+            }
+            lifetime.unsubscribe();
+        }
+        WHEN("there is no coordination and the source is quiet"){
+            auto lifetime = subscribe_groups(source.get_observable().
+                group_by_hashed([](int v){ return v % 2; }, [](int v){ return v; }, eviction, counters));
+            source.get_subscriber().on_next(1);
+            std::this_thread::sleep_for(std::chrono::milliseconds(60));
+
+            THEN("the idle group stays open until the source emits"){
+                REQUIRE(completed == 0);
+                source.get_subscriber().on_next(2);
+                REQUIRE(completed == 1);
+            }
+            lifetime.unsubscribe();
+        }
+    }
+}
@@ -0,0 +1,64 @@
+#include <rxcpp/rx.hpp>
+#include <catch2/catch.hpp>
+
+namespace rx=rxcpp;
+namespace rxo=rxcpp::operators;
+
+SCENARIO("pipe emits the same values as the lifted operators", "[pipe][operators]"){
+    GIVEN("the range 1 to 20"){
+        auto values = rx::observable<>::range(1, 20);
+
+        WHEN("the same chain is lifted and piped"){
+            std::vector<int> chained, piped;
+            values.
+                map([](int v){ return v / 3; }).
+                filter([](int v){ return v != 2; }).
+                distinct_until_changed().
+                skip(1).
+                scan(0, [](int s, int v){ return s + v; }).
+                take(4).
+                subscribe([&](int v){ chained.push_back(v); });
+            (values | rxo::pipe().
+                map([](int v){ return v / 3; }).
+                filter([](int v){ return v != 2; }).
+                distinct_until_changed().
+                skip(1).
+                scan(0, [](int s, int v){ return s + v; }).
+                take(4)).
+                subscribe([&](int v){ piped.push_back(v); });
+
+            THEN("the values match"){
+                REQUIRE(chained == std::vector<int>({1, 4, 8, 13}));
+                REQUIRE(piped == chained);
+            }
+        }
+    }
+}
+
+SCENARIO("pipe take(0) completes on subscribe", "[pipe][operators]"){
+    GIVEN("a source that counts its subscriptions"){
+        int subscribed = 0;
+        auto source = rx::observable<>::create<int>([&](rx::subscriber<int> out){
+            ++subscribed;
+            out.on_next(1);
+            out.on_completed();
+        });
+
+        for (int count : {0, -1}) {
+            WHEN("take is given a count that is not positive"){
+                int values = 0;
+                int completed = 0;
+                (source | rxo::pipe().map([](int v){ return v; }).take(count)).
+                    subscribe(
+                        [&](int){ ++values; },
+                        [&](){ ++completed; });
+
+                THEN("the pipe completes without a value and the source is not subscribed"){
+                    REQUIRE(values == 0);
+                    REQUIRE(completed == 1);
+                    REQUIRE(subscribed == 0);
+                }
+            }
+        }
+    }
+}
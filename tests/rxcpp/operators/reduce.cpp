@@ -0,0 +1,52 @@
+#include <rxcpp/rx.hpp>
+#include <catch2/catch.hpp>
+
+namespace rx=rxcpp;
+
+SCENARIO("reduce and scan accept an accumulator that takes the seed by reference", "[reduce][scan][operators]"){
+    GIVEN("the range 1 to 5"){
+        auto values = rx::observable<>::range(1, 5);
+
+        WHEN("reduce is given Seed(Seed&, T)"){
+            std::vector<int> results;
+            values.
+                reduce(0, [](int& s, int v){ return s + v; }, [](int s){ return s; }).
+                subscribe([&](int r){ results.push_back(r); });
+
+            THEN("the sum is emitted"){
+                REQUIRE(results == std::vector<int>({15}));
+            }
+        }
+        WHEN("scan is given Seed(Seed&, T)"){
+            std::vector<int> results;
+            values.
+                scan(0, [](int& s, int v){ return s + v; }).
+                subscribe([&](int r){ results.push_back(r); });
+
+            THEN("each partial sum is emitted"){
+                REQUIRE(results == std::vector<int>({1, 3, 6, 10, 15}));
+            }
+        }
+        WHEN("reduce is given Seed(Seed, T) and a seed that owns storage"){
+            std::vector<std::vector<int>> results;
+            values.
+                reduce(std::vector<int>(), [](std::vector<int> s, int v){ s.push_back(v); return s; }, [](std::vector<int> s){ return s; }).
+                subscribe([&](std::vector<int> r){ results.push_back(r); });
+
+            THEN("every value is in the seed"){
+                REQUIRE(results.size() == 1);
+                REQUIRE(results[0] == std::vector<int>({1, 2, 3, 4, 5}));
+            }
+        }
+        WHEN("reduce is given void(Seed&, T)"){
+            std::vector<int> results;
+            values.
+                reduce(0, [](int& s, int v){ s += v; }, [](int s){ return s; }).
+                subscribe([&](int r){ results.push_back(r); });
+
+            THEN("the seed is updated in place"){
+                REQUIRE(results == std::vector<int>({15}));
+            }
+        }
+    }
+}
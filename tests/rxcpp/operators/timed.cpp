@@ -0,0 +1,27 @@
+#include <rxcpp/rx.hpp>
+#include <catch2/catch.hpp>
+
+namespace rx=rxcpp;
+
+SCENARIO("the timed operators reject a period that is not positive", "[sample][throttle_first][debounce][delay][timeout][operators]"){
+    GIVEN("a source and the current thread"){
+        auto values = rx::observable<>::range(1, 3);
+        auto cn = rx::identity_current_thread();
+        std::vector<std::chrono::milliseconds> periods = {std::chrono::milliseconds(0), std::chrono::milliseconds(-1)};
+
+        for (auto period : periods) {
+            THEN("each operator throws std::invalid_argument"){
+                REQUIRE_THROWS_AS(values.sample(period, cn), std::invalid_argument);
+                REQUIRE_THROWS_AS(values.throttle_first(period, cn), std::invalid_argument);
+                REQUIRE_THROWS_AS(values.debounce(period, cn), std::invalid_argument);
+                REQUIRE_THROWS_AS(values.delay(period, cn), std::invalid_argument);
+                REQUIRE_THROWS_AS(values.timeout(period, cn), std::invalid_argument);
+                REQUIRE_THROWS_AS(values | rx::operators::debounce(period, cn), std::invalid_argument);
+            }
+        }
+        THEN("a positive period is accepted"){
+            REQUIRE_NOTHROW(values.sample(std::chrono::milliseconds(1), cn));
+            REQUIRE_NOTHROW(values.timeout(std::chrono::milliseconds(1), cn));
+        }
+    }
+}
@@ -0,0 +1,86 @@
+#include <rxcpp/rx.hpp>
+#include <catch2/catch.hpp>
+
+namespace rx=rxcpp;
+namespace rxsc=rxcpp::schedulers;
+
+SCENARIO("elastic_event_loop drops the queued actions of an unsubscribed worker", "[elastic_event_loop][scheduler]"){
+    GIVEN("an elastic event loop with one thread"){
+        auto sc = rxsc::make_elastic_event_loop(
+            rxsc::thread_factory([](std::function<void()> start){ return std::thread(std::move(start)); }),
+            1, std::chrono::seconds(1));
+        std::atomic<int> ran(0);
+
+        WHEN("a worker is unsubscribed while its action waits"){
+            rx::composite_subscription cs;
+            auto w = sc.create_worker(cs);
+            w.schedule(w.now() + std::chrono::milliseconds(50), [&](const rxsc::schedulable&){
+                ++ran;
+            });
+            cs.unsubscribe();
+            std::this_thread::sleep_for(std::chrono::milliseconds(150));
+
+            THEN("the action does not run"){
+                REQUIRE(ran == 0);
+            }
+        }
+        WHEN("a worker is unsubscribed while an action made on another worker waits"){
+            rx::composite_subscription cs;
+            auto w = sc.create_worker(cs);
+            auto other = rxsc::make_current_thread().create_worker();
+            w.schedule(w.now() + std::chrono::milliseconds(50), rxsc::make_schedulable(other, [&](const rxsc::schedulable&){
+                ++ran;
+            }));
+            cs.unsubscribe();
+            std::this_thread::sleep_for(std::chrono::milliseconds(150));
+            other.unsubscribe();
+
+            THEN("the action does not run"){
+                REQUIRE(ran == 0);
+            }
+        }
+        WHEN("an action reschedules itself until the worker is unsubscribed"){
+            rx::composite_subscription cs;
+            auto w = sc.create_worker(cs);
+            std::atomic<bool> stopped(false);
+            w.schedule([&](const rxsc::schedulable& self){
+                if (++ran == 3) {
+                    cs.unsubscribe();
+                    stopped = true;
+                }
+                self.schedule(self.now() + std::chrono::milliseconds(1));
+            });
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+            while (!stopped && std::chrono::steady_clock::now() < deadline) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+            THEN("it ran until then and no more"){
+                REQUIRE(ran == 3);
+            }
+        }
+        WHEN("another worker on the loop is unsubscribed"){
+            rx::composite_subscription other;
+            auto gone = sc.create_worker(other);
+            gone.schedule(gone.now() + std::chrono::milliseconds(20), [&](const rxsc::schedulable&){
+                ran += 100;
+            });
+            auto w = sc.create_worker();
+            std::atomic<bool> done(false);
+            w.schedule(w.now() + std::chrono::milliseconds(20), [&](const rxsc::schedulable&){
+                ++ran;
+                done = true;
+            });
+            other.unsubscribe();
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+            while (!done && std::chrono::steady_clock::now() < deadline) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+
+            THEN("only its actions are dropped"){
+                REQUIRE(ran == 1);
+            }
+        }
+    }
+}
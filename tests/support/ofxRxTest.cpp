@@ -0,0 +1,110 @@
+#include "ofxRxTest.h"
+
+namespace {
+
+uint64_t& frame_number()
+{
+    static uint64_t number = 0;
+    return number;
+}
+
+rxcpp::subjects::subject<ofEventArgs>& update_events()
+{
+    static rxcpp::subjects::subject<ofEventArgs> events;
+    return events;
+}
+
+std::chrono::steady_clock::time_point started()
+{
+    static auto start = std::chrono::steady_clock::now();
+    return start;
+}
+
+}
+
+uint64_t ofGetFrameNum()
+{
+    return frame_number();
+}
+
+unsigned long long ofGetElapsedTimeMicros()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started()).count();
+}
+
+unsigned long long ofGetElapsedTimeMillis()
+{
+    return ofGetElapsedTimeMicros() / 1000;
+}
+
+float ofGetElapsedTimef()
+{
+    return ofGetElapsedTimeMicros() / 1000000.0f;
+}
+
+namespace ofxRxTest {
+
+void frame()
+{
+    ++frame_number();
+    update_events().get_subscriber().on_next(ofEventArgs());
+}
+
+}
+
+namespace ofx {
+
+namespace rx {
+
+// the update events come from ofxRxTest::frame()
+
+Updates::~Updates() {
+    clear();
+}
+Updates::Updates()
+:
+dest_updates(sub_updates.get_subscriber().as_dynamic())
+{
+    registered = false;
+}
+
+void Updates::setup() {
+    registered = true;
+}
+void Updates::clear() {
+    registered = false;
+}
+
+rx::observable<ofEventArgs> Updates::events() const
+{
+    return update_events().get_observable().as_dynamic();
+}
+
+rx::observable<unsigned long long> Updates::milliseconds() const
+{
+    return events().
+        map([](const ofEventArgs&){return ofGetElapsedTimeMillis();}).
+        as_dynamic();
+}
+
+rx::observable<unsigned long long> Updates::microseconds() const
+{
+    return events().
+        map([](const ofEventArgs&){return ofGetElapsedTimeMicros();}).
+        as_dynamic();
+}
+
+rx::observable<float> Updates::floats() const
+{
+    return events().
+        map([](const ofEventArgs&){return ofGetElapsedTimef();}).
+        as_dynamic();
+}
+
+void Updates::update(ofEventArgs& a){
+    dest_updates.on_next(a);
+}
+
+}
+
+}
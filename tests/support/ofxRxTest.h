@@ -0,0 +1,50 @@
+//
+//  ofxRxTest.h
+//
+//  the parts of openframeworks that the ofxRx headers use, for the tests
+//  and the benchmarks. the update events are sent by the test instead of
+//  ofEvents().update.
+//
+
+#ifndef OFXRXTEST_H
+#define OFXRXTEST_H
+
+#include <cassert>
+#include <cstdint>
+
+#include <rxcpp/rx.hpp>
+
+struct ofEventArgs
+{
+};
+
+uint64_t ofGetFrameNum();
+unsigned long long ofGetElapsedTimeMillis();
+unsigned long long ofGetElapsedTimeMicros();
+float ofGetElapsedTimef();
+
+namespace ofx {
+
+namespace rx {
+
+namespace rx=rxcpp;
+namespace rxsc=rxcpp::rxsc;
+
+}
+
+}
+
+namespace ofxRx = ofx::rx;
+
+#include "ofxRxBufferRef.h"
+#include "ofxRxChunked.h"
+#include "ofxRxUpdates.h"
+
+namespace ofxRxTest {
+
+/// starts the next frame and sends its update event to the Updates sources
+void frame();
+
+}
+
+#endif